@@ -0,0 +1,96 @@
+#include "arena.h"
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+void initArena(MemoryArena *arena, const char *name, void *base, size_t size)
+{
+	snprintf(arena->name, sizeof(arena->name), "%s", name);
+	relPtrSet(&arena->base, base);
+	arena->size = size;
+	arena->used = 0;
+	arena->highWater = 0;
+	arena->resetHighWater = 0;
+}
+
+uint8_t *arenaBase(const MemoryArena *arena)
+{
+	return RelPtrGet(arena->base, uint8_t);
+}
+
+// Returns zeroed memory aligned to alignment (a power of two), or NULL when
+// the arena is exhausted. Running out is left to the caller to report, in
+// every build, so a host asking for too much gets an error instead of a
+// crash.
+void *pushSize(MemoryArena *arena, size_t size, size_t alignment)
+{
+	assert(alignment && (alignment & (alignment - 1)) == 0);
+
+	uint8_t *base = arenaBase(arena);
+	uintptr_t current = (uintptr_t)base + arena->used;
+	size_t padding = (alignment - (current & (alignment - 1))) & (alignment - 1);
+	size_t remaining = arena->size - arena->used;
+
+	if (padding > remaining || size > remaining - padding)
+	{
+		return NULL;
+	}
+
+	void *result = base + arena->used + padding;
+	arena->used += padding + size;
+	if (arena->used > arena->highWater)
+	{
+		arena->highWater = arena->used;
+	}
+	if (arena->used > arena->resetHighWater)
+	{
+		arena->resetHighWater = arena->used;
+	}
+
+	memset(result, 0, size);
+	return result;
+}
+
+// Carves a child arena out of parent, for systems that want to reset their
+// own memory without touching anything else in the block.
+void subArena(MemoryArena *result, MemoryArena *parent, const char *name, size_t size)
+{
+	void *base = pushSize(parent, size, DEFAULT_ARENA_ALIGNMENT);
+	initArena(result, name, base, base ? size : 0);
+}
+
+size_t arenaRemaining(const MemoryArena *arena)
+{
+	return arena->size - arena->used;
+}
+
+ArenaMark arenaMark(MemoryArena *arena)
+{
+	ArenaMark mark = { arena, arena->used };
+	return mark;
+}
+
+void arenaRewind(ArenaMark mark)
+{
+	assert(mark.used <= mark.arena->used);
+#ifdef ARENA_DEBUG
+	memset(arenaBase(mark.arena) + mark.used, ARENA_POISON_BYTE, mark.arena->used - mark.used);
+#endif
+	mark.arena->used = mark.used;
+}
+
+void arenaReset(MemoryArena *arena)
+{
+#ifdef ARENA_DEBUG
+	memset(arenaBase(arena), ARENA_POISON_BYTE, arena->used);
+#endif
+	arena->used = 0;
+	arena->resetHighWater = 0;
+}
+
+void reportArena(const MemoryArena *arena)
+{
+	printf("arena %-10s used %10zu  peak %10zu  of %10zu bytes (%.2f%%)\n",
+		arena->name, arena->used, arena->highWater, arena->size,
+		arena->size ? 100.0 * (double)arena->highWater / (double)arena->size : 0.0);
+}
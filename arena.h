@@ -0,0 +1,86 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Bump allocator over one of the GameMemory blocks. Everything that lives in
+// permanent or transient storage is pushed through one of these so layouts
+// can never overlap, and highWater tells how much of the reservation was
+// actually touched.
+#define ARENA_NAME_LENGTH 16
+
+// Self-relative pointer: the distance in bytes from the field itself to its
+// target, 0 for NULL. A block whose references are all of these points to
+// the same places wherever it is mapped, so it can be copied, mapped or
+// compared as plain bytes. The flip side: a struct holding one must not be
+// copied to another address by value.
+//
+// The arithmetic goes through uintptr_t: field and target are often
+// different objects (a local bootstrap arena and the block it describes),
+// and pointer arithmetic between those lets the optimiser, with LTO in
+// particular, assume the result still points into field's object.
+typedef int64_t RelPtr;
+
+static inline void *relPtrGet(const RelPtr *field)
+{
+	return *field ? (void *)((uintptr_t)field + (uintptr_t)*field) : NULL;
+}
+
+static inline void relPtrSet(RelPtr *field, const void *target)
+{
+	*field = target ? (int64_t)((uintptr_t)target - (uintptr_t)field) : 0;
+}
+
+#define RelPtrGet(Field, type) ((type *)relPtrGet(&(Field)))
+
+typedef struct MemoryArena
+{
+	// inline rather than a pointer to a literal, so an arena stored in
+	// GameMemory stays valid across a code reload or a state restore
+	char name[ARENA_NAME_LENGTH];
+	// relative, so an arena kept inside its own block moves with it
+	RelPtr base;
+	size_t size;
+	size_t used;
+	size_t highWater;
+	// highWater since the last arenaReset, for arenas reset once a frame
+	size_t resetHighWater;
+} MemoryArena;
+
+// Saved arena position; rewinding releases everything pushed after it.
+typedef struct ArenaMark
+{
+	MemoryArena *arena;
+	size_t used;
+} ArenaMark;
+
+#define Kilobytes(Value) ((Value) * 1024LL)
+#define Megabytes(Value) (Kilobytes(Value) * 1024LL)
+
+#define DEFAULT_ARENA_ALIGNMENT 16
+
+// Build with -DARENA_DEBUG to fill released memory with this byte on rewind
+// and reset, so reads through stale scratch pointers show up immediately.
+#define ARENA_POISON_BYTE 0xCD
+
+#define PushStruct(Arena, type) ((type *)pushSize((Arena), sizeof(type), _Alignof(type)))
+#define PushArray(Arena, Count, type) ((type *)pushSize((Arena), (size_t)(Count) * sizeof(type), _Alignof(type)))
+#define PushSize(Arena, Size) pushSize((Arena), (Size), DEFAULT_ARENA_ALIGNMENT)
+#define PushSizeAligned(Arena, Size, Alignment) pushSize((Arena), (Size), (Alignment))
+
+//functions==================
+//
+void initArena(MemoryArena *arena, const char *name, void *base, size_t size);
+uint8_t *arenaBase(const MemoryArena *arena);
+void *pushSize(MemoryArena *arena, size_t size, size_t alignment);
+void subArena(MemoryArena *result, MemoryArena *parent, const char *name, size_t size);
+size_t arenaRemaining(const MemoryArena *arena);
+ArenaMark arenaMark(MemoryArena *arena);
+void arenaRewind(ArenaMark mark);
+void arenaReset(MemoryArena *arena);
+void reportArena(const MemoryArena *arena);
+//
+//===========================
+
+#endif
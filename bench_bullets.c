@@ -0,0 +1,142 @@
+#include "bullets.h"
+#include "platform.h"
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+// Microbenchmark for the projectile update: the original array-of-structs
+// loop (fat Bullet, active flag, stored collider, frame time fetched per
+// bullet) against the BulletPool integrate + cull kernels.
+
+#define BENCH_REPS 200
+#define BENCH_DT (1.0f / 120.0f)
+#define BENCH_HEIGHT 320.0f
+
+typedef struct LegacyBullet
+{
+	Vector2 position;
+	Vector2 startPos;
+	Vector2 velocity;
+	Rectangle collider;
+	bool active;
+} LegacyBullet;
+
+//functions==================
+//
+float benchFrameTime(void);
+void legacyUpdateBullets(LegacyBullet *bullets, int count);
+double benchLegacy(int count, uint8_t *scratch);
+double benchPool(int count, uint8_t *scratch, size_t scratchSize);
+//
+//===========================
+
+static volatile float frameTime = BENCH_DT;
+
+// Stands in for GetFrameTime(), an opaque call the old loop made per bullet.
+#if defined(_MSC_VER)
+__declspec(noinline)
+#else
+__attribute__((noinline))
+#endif
+float benchFrameTime(void)
+{
+	return frameTime;
+}
+
+void legacyUpdateBullets(LegacyBullet *bullets, int count)
+{
+	for (int i = 0; i < count; i++) {
+		if (bullets[i].active) {
+			bullets[i].position.y += bullets[i].velocity.y * benchFrameTime();
+
+			bullets[i].collider.x = bullets[i].position.x - 2.5f;
+			bullets[i].collider.y = bullets[i].position.y;
+
+			if (bullets[i].position.y < 0) {
+				bullets[i].active = false;
+			}
+		}
+	}
+}
+
+static float spawnY(int i)
+{
+	// spread over the screen so a few percent leave it every step
+	return (float)((i * 7919) % (int)BENCH_HEIGHT);
+}
+
+double benchLegacy(int count, uint8_t *scratch)
+{
+	LegacyBullet *bullets = (LegacyBullet *)scratch;
+	double total = 0.0;
+	for (int rep = 0; rep < BENCH_REPS; rep++)
+	{
+		for (int i = 0; i < count; i++)
+		{
+			bullets[i].position = (Vector2){ (float)(i % 640), spawnY(i) };
+			bullets[i].velocity = (Vector2){ 0, -BULLET_SPEED };
+			bullets[i].active = true;
+		}
+		double start = platformGetSeconds();
+		legacyUpdateBullets(bullets, count);
+		total += platformGetSeconds() - start;
+	}
+	return total / BENCH_REPS;
+}
+
+double benchPool(int count, uint8_t *scratch, size_t scratchSize)
+{
+	MemoryArena arena;
+	initArena(&arena, "bench", scratch, scratchSize);
+	// in the same block as its arrays, like the one in State
+	BulletPool *pool = PushStruct(&arena, BulletPool);
+	if (!pool || !initBulletPool(pool, &arena, count))
+	{
+		return 0.0;
+	}
+
+	double total = 0.0;
+	for (int rep = 0; rep < BENCH_REPS; rep++)
+	{
+		clearBulletPool(pool);
+		for (int i = 0; i < count; i++)
+		{
+			spawnBullet(pool, (Vector2){ (float)(i % 640), spawnY(i) }, (Vector2){ 0, -BULLET_SPEED });
+		}
+		double start = platformGetSeconds();
+		integrateBullets(pool, benchFrameTime());
+		cullBullets(pool, 0.0f);
+		total += platformGetSeconds() - start;
+	}
+	return total / BENCH_REPS;
+}
+
+int main(void)
+{
+	const int counts[] = { 1000, 10000, 100000 };
+	size_t scratchSize = Megabytes(16);
+	uint8_t *scratch = (uint8_t *)malloc(scratchSize);
+	if (!scratch)
+	{
+		return -1;
+	}
+
+#if defined(__AVX2__)
+	const char *kernel = "avx2";
+#elif defined(__SSE2__) || defined(_M_X64)
+	const char *kernel = "sse2";
+#else
+	const char *kernel = "scalar";
+#endif
+
+	printf("%8s %14s %14s %8s  (kernel: %s)\n", "bullets", "legacy us", "pool us", "speedup", kernel);
+	for (size_t c = 0; c < sizeof(counts) / sizeof(counts[0]); c++)
+	{
+		double legacy = benchLegacy(counts[c], scratch);
+		double pool = benchPool(counts[c], scratch, scratchSize);
+		printf("%8d %14.2f %14.2f %7.1fx\n", counts[c], legacy * 1e6, pool * 1e6, pool > 0.0 ? legacy / pool : 0.0);
+	}
+
+	free(scratch);
+	return 0;
+}
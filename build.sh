@@ -4,9 +4,14 @@
 INCLUDE_DIR="."
 LIB_DIR="."
 OUTPUT="out.exe"
+HEADLESS_OUTPUT="headless.exe"
+BENCH_OUTPUT="bench_bullets.exe"
 
-# Source file
-SRC_FILE="main.c"
+# Source files
+SIM_FILES="sim.c shapes.c bullets.c collision.c arena.c platform.c jobs.c replay.c rng.c logger.c profiler.c render_commands.c game.c game_code.c snapshot.c"
+SRC_FILES="main.c render.c sim_thread.c $SIM_FILES"
+HEADLESS_FILES="headless.c $SIM_FILES"
+BENCH_FILES="bench_bullets.c bullets.c arena.c platform.c"
 
 # Compiler flags
 CFLAGS="-Wall -Wextra -g"
@@ -15,7 +20,14 @@ CFLAGS="-Wall -Wextra -g"
 LIBS="-lraylib -luser32 -lgdi32 -ladvapi32 -lwinmm -lshell32 -lmsvcrt"
 
 # Compile and link
-clang $CFLAGS -o $OUTPUT $SRC_FILE -I$INCLUDE_DIR -L$LIB_DIR $LIBS
+clang $CFLAGS -o $OUTPUT $SRC_FILES -I$INCLUDE_DIR -L$LIB_DIR $LIBS
+
+# Headless simulation runner, no raylib window so no raylib link
+if [ $? -eq 0 ]; then
+    clang $CFLAGS -o $HEADLESS_OUTPUT $HEADLESS_FILES -I$INCLUDE_DIR
+    # Add -mavx2 to pick the 8-wide bullet kernels over SSE2
+    clang $CFLAGS -O2 -o $BENCH_OUTPUT $BENCH_FILES -I$INCLUDE_DIR
+fi
 
 # Check if the compilation was successful
 if [ $? -eq 0 ]; then
@@ -0,0 +1,193 @@
+#include "bullets.h"
+#include <assert.h>
+
+#if defined(__AVX2__)
+#    include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#    include <emmintrin.h>
+#endif
+
+// False when arena cannot hold the lanes; the pool is then left empty with
+// no capacity.
+bool initBulletPool(BulletPool *pool, MemoryArena *arena, int32_t capacity)
+{
+	int32_t padded = (capacity + BULLET_POOL_LANES - 1) & ~(BULLET_POOL_LANES - 1);
+	size_t bytes = (size_t)padded * sizeof(float);
+
+	float *x = (float *)PushSizeAligned(arena, bytes, 32);
+	float *y = (float *)PushSizeAligned(arena, bytes, 32);
+	float *vx = (float *)PushSizeAligned(arena, bytes, 32);
+	float *vy = (float *)PushSizeAligned(arena, bytes, 32);
+	bool ok = x && y && vx && vy;
+	relPtrSet(&pool->x, ok ? x : NULL);
+	relPtrSet(&pool->y, ok ? y : NULL);
+	relPtrSet(&pool->vx, ok ? vx : NULL);
+	relPtrSet(&pool->vy, ok ? vy : NULL);
+	pool->count = 0;
+	pool->capacity = ok ? capacity : 0;
+	return ok;
+}
+
+BulletArrays bulletArrays(const BulletPool *pool)
+{
+	BulletArrays arrays = {
+		RelPtrGet(pool->x, float),
+		RelPtrGet(pool->y, float),
+		RelPtrGet(pool->vx, float),
+		RelPtrGet(pool->vy, float)
+	};
+	return arrays;
+}
+
+// Returns the new bullet's index, or -1 when the pool is full.
+int32_t spawnBullet(BulletPool *pool, Vector2 position, Vector2 velocity)
+{
+	if (pool->count >= pool->capacity)
+	{
+		return -1;
+	}
+
+	BulletArrays bullets = bulletArrays(pool);
+	int32_t index = pool->count++;
+	bullets.x[index] = position.x;
+	bullets.y[index] = position.y;
+	bullets.vx[index] = velocity.x;
+	bullets.vy[index] = velocity.y;
+	return index;
+}
+
+void despawnBullet(BulletPool *pool, int32_t index)
+{
+	assert(index >= 0 && index < pool->count);
+
+	BulletArrays bullets = bulletArrays(pool);
+	int32_t last = --pool->count;
+	bullets.x[index] = bullets.x[last];
+	bullets.y[index] = bullets.y[last];
+	bullets.vx[index] = bullets.vx[last];
+	bullets.vy[index] = bullets.vy[last];
+}
+
+void clearBulletPool(BulletPool *pool)
+{
+	pool->count = 0;
+}
+
+// Colliders are not stored, they are a fixed box hanging off the position.
+Rectangle bulletCollider(const BulletPool *pool, int32_t index)
+{
+	const float *x = RelPtrGet(pool->x, float);
+	const float *y = RelPtrGet(pool->y, float);
+	return (Rectangle){ x[index] - BULLET_WIDTH / 2.0f, y[index], BULLET_WIDTH, BULLET_HEIGHT };
+}
+
+// Collider as it was dt seconds ago, i.e. at the start of the tick that was
+// just integrated.
+Rectangle bulletStartCollider(const BulletPool *pool, int32_t index, float dt)
+{
+	Rectangle collider = bulletCollider(pool, index);
+	Vector2 motion = bulletMotion(pool, index, dt);
+	collider.x -= motion.x;
+	collider.y -= motion.y;
+	return collider;
+}
+
+Vector2 bulletMotion(const BulletPool *pool, int32_t index, float dt)
+{
+	const float *vx = RelPtrGet(pool->vx, float);
+	const float *vy = RelPtrGet(pool->vy, float);
+	return (Vector2){ vx[index] * dt, vy[index] * dt };
+}
+
+// Advances every live bullet by its velocity. Runs whole vector lanes over
+// the padded arrays (AVX2: 8, SSE2: 4) and falls back to a plain loop that
+// compilers can auto-vectorise elsewhere. Colliders need no update since they
+// are derived from the position.
+void integrateBullets(BulletPool *pool, float dt)
+{
+	integrateBulletRange(pool, 0, pool->count, dt);
+}
+
+// Same over [begin, end). Whole lane groups are written, so begin and (unless
+// it is count) end must be multiples of BULLET_POOL_LANES for ranges running
+// on different threads not to overlap.
+void integrateBulletRange(BulletPool *pool, int32_t begin, int32_t end, float dt)
+{
+	BulletArrays bullets = bulletArrays(pool);
+	int32_t i = begin;
+#if defined(__AVX2__)
+	__m256 step = _mm256_set1_ps(dt);
+	for (; i < end; i += 8)
+	{
+		__m256 x = _mm256_load_ps(bullets.x + i);
+		__m256 y = _mm256_load_ps(bullets.y + i);
+		x = _mm256_add_ps(x, _mm256_mul_ps(_mm256_load_ps(bullets.vx + i), step));
+		y = _mm256_add_ps(y, _mm256_mul_ps(_mm256_load_ps(bullets.vy + i), step));
+		_mm256_store_ps(bullets.x + i, x);
+		_mm256_store_ps(bullets.y + i, y);
+	}
+#elif defined(__SSE2__) || defined(_M_X64)
+	__m128 step = _mm_set1_ps(dt);
+	for (; i < end; i += 4)
+	{
+		__m128 x = _mm_load_ps(bullets.x + i);
+		__m128 y = _mm_load_ps(bullets.y + i);
+		x = _mm_add_ps(x, _mm_mul_ps(_mm_load_ps(bullets.vx + i), step));
+		y = _mm_add_ps(y, _mm_mul_ps(_mm_load_ps(bullets.vy + i), step));
+		_mm_store_ps(bullets.x + i, x);
+		_mm_store_ps(bullets.y + i, y);
+	}
+#else
+	for (; i < end; i++)
+	{
+		bullets.x[i] += bullets.vx[i] * dt;
+		bullets.y[i] += bullets.vy[i] * dt;
+	}
+#endif
+}
+
+// Removes bullets above minY and returns how many went. Each lane group is
+// tested at once and skipped when its mask is empty; groups are walked from
+// the back so a swap-remove only ever pulls in a bullet that already passed.
+int32_t cullBullets(BulletPool *pool, float minY)
+{
+	const float *y = RelPtrGet(pool->y, float);
+	int32_t before = pool->count;
+	int32_t groups = (pool->count + BULLET_POOL_LANES - 1) / BULLET_POOL_LANES;
+
+	for (int32_t group = groups - 1; group >= 0; group--)
+	{
+		int32_t base = group * BULLET_POOL_LANES;
+		uint32_t mask;
+#if defined(__AVX2__)
+		mask = (uint32_t)_mm256_movemask_ps(_mm256_cmp_ps(_mm256_load_ps(y + base), _mm256_set1_ps(minY), _CMP_LT_OQ));
+#elif defined(__SSE2__) || defined(_M_X64)
+		__m128 limit = _mm_set1_ps(minY);
+		mask = (uint32_t)_mm_movemask_ps(_mm_cmplt_ps(_mm_load_ps(y + base), limit))
+			| ((uint32_t)_mm_movemask_ps(_mm_cmplt_ps(_mm_load_ps(y + base + 4), limit)) << 4);
+#else
+		mask = 0;
+		for (int32_t lane = 0; lane < BULLET_POOL_LANES; lane++)
+		{
+			mask |= (uint32_t)(y[base + lane] < minY) << lane;
+		}
+#endif
+		// lanes past count are padding
+		int32_t live = pool->count - base;
+		if (live < BULLET_POOL_LANES)
+		{
+			mask &= (1u << live) - 1;
+		}
+
+		for (int32_t lane = BULLET_POOL_LANES - 1; mask; lane--)
+		{
+			if (mask & (1u << lane))
+			{
+				despawnBullet(pool, base + lane);
+				mask &= ~(1u << lane);
+			}
+		}
+	}
+
+	return before - pool->count;
+}
@@ -0,0 +1,58 @@
+#ifndef BULLETS_H
+#define BULLETS_H
+
+#include "raylib.h"
+#include "arena.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+#define BULLET_WIDTH 5.0f
+#define BULLET_HEIGHT 10.0f
+#define BULLET_SPEED 500.0f
+
+// Component arrays are padded to this many floats so batch kernels can run
+// whole vector lanes past count without bounds checks.
+#define BULLET_POOL_LANES 8
+
+// Structure-of-arrays bullet store. Live bullets are always packed into
+// [0, count): spawning appends, despawning moves the last bullet into the
+// freed slot, so updates never visit dead entries. Indices are therefore not
+// stable across a despawn. The arrays are relative pointers, so the pool
+// must sit in the same block as them and is never copied by value; go
+// through bulletArrays() to reach them.
+typedef struct BulletPool
+{
+	RelPtr x;
+	RelPtr y;
+	RelPtr vx;
+	RelPtr vy;
+	int32_t count;
+	int32_t capacity;
+} BulletPool;
+
+// The pool's arrays resolved to plain pointers, for one pass over them.
+typedef struct BulletArrays
+{
+	float *x;
+	float *y;
+	float *vx;
+	float *vy;
+} BulletArrays;
+
+//functions==================
+//
+bool initBulletPool(BulletPool *pool, MemoryArena *arena, int32_t capacity);
+BulletArrays bulletArrays(const BulletPool *pool);
+int32_t spawnBullet(BulletPool *pool, Vector2 position, Vector2 velocity);
+void despawnBullet(BulletPool *pool, int32_t index);
+void clearBulletPool(BulletPool *pool);
+void integrateBullets(BulletPool *pool, float dt);
+void integrateBulletRange(BulletPool *pool, int32_t begin, int32_t end, float dt);
+int32_t cullBullets(BulletPool *pool, float minY);
+Rectangle bulletCollider(const BulletPool *pool, int32_t index);
+Rectangle bulletStartCollider(const BulletPool *pool, int32_t index, float dt);
+Vector2 bulletMotion(const BulletPool *pool, int32_t index, float dt);
+//
+//===========================
+
+#endif
@@ -0,0 +1,354 @@
+#include "collision.h"
+#include <math.h>
+#include <string.h>
+
+#if defined(_MSC_VER)
+#    include <intrin.h>
+#endif
+#if defined(__AVX2__)
+#    include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#    include <emmintrin.h>
+#endif
+
+// Entries handled per mask chunk when scanning a grid cell.
+#define OVERLAP_CHUNK 256
+
+// bits must not be 0
+static int32_t lowestBit(uint32_t bits)
+{
+#if defined(_MSC_VER)
+	unsigned long index;
+	_BitScanForward(&index, bits);
+	return (int32_t)index;
+#else
+	return __builtin_ctz(bits);
+#endif
+}
+
+// False when arena runs out part way.
+bool initColliderSoA(ColliderSoA *colliders, MemoryArena *arena, int32_t count)
+{
+	size_t bytes = (size_t)(count + COLLIDER_LANES) * sizeof(float);
+	colliders->minX = (float *)PushSizeAligned(arena, bytes, 32);
+	colliders->minY = (float *)PushSizeAligned(arena, bytes, 32);
+	colliders->maxX = (float *)PushSizeAligned(arena, bytes, 32);
+	colliders->maxY = (float *)PushSizeAligned(arena, bytes, 32);
+	colliders->count = count;
+	return colliders->minX && colliders->minY && colliders->maxX && colliders->maxY;
+}
+
+void setCollider(ColliderSoA *colliders, int32_t index, Rectangle box)
+{
+	colliders->minX[index] = box.x;
+	colliders->minY[index] = box.y;
+	colliders->maxX[index] = box.x + box.width;
+	colliders->maxY[index] = box.y + box.height;
+}
+
+int32_t overlapMaskWords(int32_t count)
+{
+	return (count + 31) / 32;
+}
+
+// Sets bit i of mask when box overlaps colliders[first + i], for i < count.
+// Same strict test as checkCollision(), done 8 (AVX2) or 4 (SSE2) colliders
+// at a time with no branches; mask needs overlapMaskWords(count) words.
+void aabbOverlapMask(Rectangle box, const ColliderSoA *colliders, int32_t first, int32_t count, uint32_t *mask)
+{
+	const float *minX = colliders->minX + first;
+	const float *minY = colliders->minY + first;
+	const float *maxX = colliders->maxX + first;
+	const float *maxY = colliders->maxY + first;
+	float boxMinX = box.x;
+	float boxMinY = box.y;
+	float boxMaxX = box.x + box.width;
+	float boxMaxY = box.y + box.height;
+
+	memset(mask, 0, overlapMaskWords(count) * sizeof(uint32_t));
+
+	int32_t i = 0;
+#if defined(__AVX2__)
+	__m256 bMinX = _mm256_set1_ps(boxMinX);
+	__m256 bMinY = _mm256_set1_ps(boxMinY);
+	__m256 bMaxX = _mm256_set1_ps(boxMaxX);
+	__m256 bMaxY = _mm256_set1_ps(boxMaxY);
+	for (; i + 8 <= count; i += 8)
+	{
+		__m256 x = _mm256_and_ps(_mm256_cmp_ps(bMinX, _mm256_loadu_ps(maxX + i), _CMP_LT_OQ),
+			_mm256_cmp_ps(bMaxX, _mm256_loadu_ps(minX + i), _CMP_GT_OQ));
+		__m256 y = _mm256_and_ps(_mm256_cmp_ps(bMinY, _mm256_loadu_ps(maxY + i), _CMP_LT_OQ),
+			_mm256_cmp_ps(bMaxY, _mm256_loadu_ps(minY + i), _CMP_GT_OQ));
+		mask[i >> 5] |= (uint32_t)_mm256_movemask_ps(_mm256_and_ps(x, y)) << (i & 31);
+	}
+#elif defined(__SSE2__) || defined(_M_X64)
+	__m128 bMinX = _mm_set1_ps(boxMinX);
+	__m128 bMinY = _mm_set1_ps(boxMinY);
+	__m128 bMaxX = _mm_set1_ps(boxMaxX);
+	__m128 bMaxY = _mm_set1_ps(boxMaxY);
+	for (; i + 4 <= count; i += 4)
+	{
+		__m128 x = _mm_and_ps(_mm_cmplt_ps(bMinX, _mm_loadu_ps(maxX + i)),
+			_mm_cmpgt_ps(bMaxX, _mm_loadu_ps(minX + i)));
+		__m128 y = _mm_and_ps(_mm_cmplt_ps(bMinY, _mm_loadu_ps(maxY + i)),
+			_mm_cmpgt_ps(bMaxY, _mm_loadu_ps(minY + i)));
+		mask[i >> 5] |= (uint32_t)_mm_movemask_ps(_mm_and_ps(x, y)) << (i & 31);
+	}
+#endif
+	for (; i < count; i++)
+	{
+		uint32_t hit = (boxMinX < maxX[i]) & (boxMaxX > minX[i]) & (boxMinY < maxY[i]) & (boxMaxY > minY[i]);
+		mask[i >> 5] |= hit << (i & 31);
+	}
+}
+
+// Narrows the [entry, exit) window to the times the moving span [lo, hi)
+// overlaps [minB, maxB) on one axis.
+static bool sweepAxis(float lo, float hi, float delta, float minB, float maxB, float *entry, float *exit)
+{
+	if (delta == 0.0f)
+	{
+		return lo < maxB && hi > minB;
+	}
+
+	float inverse = 1.0f / delta;
+	float t0 = (minB - hi) * inverse;
+	float t1 = (maxB - lo) * inverse;
+	if (t0 > t1)
+	{
+		float swap = t0;
+		t0 = t1;
+		t1 = swap;
+	}
+	if (t0 > *entry)
+	{
+		*entry = t0;
+	}
+	if (t1 < *exit)
+	{
+		*exit = t1;
+	}
+	return *entry < *exit;
+}
+
+// Slab test shared by the narrow phase and the grid query, so both agree on
+// every hit: box moving by delta against the box [minX, maxX] x [minY, maxY].
+static bool sweepBox(Rectangle box, Vector2 delta, float minX, float minY, float maxX, float maxY, float *toi)
+{
+	float entry = 0.0f;
+	float exit = 1.0f;
+	if (sweepAxis(box.x, box.x + box.width, delta.x, minX, maxX, &entry, &exit)
+		&& sweepAxis(box.y, box.y + box.height, delta.y, minY, maxY, &entry, &exit))
+	{
+		*toi = entry;
+		return true;
+	}
+	return false;
+}
+
+static bool sweepBounds(Rectangle box, Vector2 delta, const ColliderSoA *bounds, int32_t index, float *toi)
+{
+	return sweepBox(box, delta, bounds->minX[index], bounds->minY[index], bounds->maxX[index], bounds->maxY[index], toi);
+}
+
+// Swept AABB: box moving by delta over the tick against a static target,
+// i.e. a ray against the target grown by box's extents. On a hit toi is the
+// fraction of delta travelled at first contact, 0 if they already overlap.
+bool sweptAabb(Rectangle box, Vector2 delta, Rectangle target, float *toi)
+{
+	return sweepBox(box, delta, target.x, target.y, target.x + target.width, target.y + target.height, toi);
+}
+
+// Box covering everything box touches while moving by delta, for culling
+// swept tests with the plain overlap kernels.
+Rectangle sweptBounds(Rectangle box, Vector2 delta)
+{
+	Rectangle result = box;
+	if (delta.x < 0.0f)
+	{
+		result.x += delta.x;
+	}
+	if (delta.y < 0.0f)
+	{
+		result.y += delta.y;
+	}
+	result.width += fabsf(delta.x);
+	result.height += fabsf(delta.y);
+	return result;
+}
+
+// Keeps the earlier of two hits, the lower index on a tie.
+static void takeEarlierHit(SweepHit *best, int32_t item, float toi)
+{
+	if (best->item < 0 || toi < best->toi || (toi == best->toi && item < best->item))
+	{
+		best->item = item;
+		best->toi = toi;
+	}
+}
+
+// Earliest live hit among the candidates set in mask, where mask came from
+// testing sweptBounds(box, delta) against bounds.
+SweepHit firstSweptHit(const uint32_t *mask, int32_t words, const bool *alive, const ColliderSoA *bounds, Rectangle box, Vector2 delta)
+{
+	SweepHit best = { -1, 0.0f };
+	for (int32_t word = 0; word < words; word++)
+	{
+		for (uint32_t bits = mask[word]; bits; bits &= bits - 1)
+		{
+			int32_t item = word * 32 + lowestBit(bits);
+			float toi;
+			if (alive[item] && sweepBounds(box, delta, bounds, item, &toi))
+			{
+				takeEarlierHit(&best, item, toi);
+			}
+		}
+	}
+	return best;
+}
+
+// Every a against every b. Row r of masks (overlapMaskWords(b->count) words)
+// holds the overlaps of a[r]. Meant for sets small enough that binning them
+// first would cost more than the tests.
+void aabbOverlapAllPairs(const ColliderSoA *a, const ColliderSoA *b, uint32_t *masks)
+{
+	int32_t words = overlapMaskWords(b->count);
+	for (int32_t r = 0; r < a->count; r++)
+	{
+		Rectangle box = { a->minX[r], a->minY[r], a->maxX[r] - a->minX[r], a->maxY[r] - a->minY[r] };
+		aabbOverlapMask(box, b, 0, b->count, masks + (size_t)r * words);
+	}
+}
+
+void initCollisionGrid(CollisionGrid *grid, float width, float height, float cellSize)
+{
+	grid->cellSize = cellSize;
+	grid->invCellSize = 1.0f / cellSize;
+	grid->columns = (int32_t)ceilf(width / cellSize);
+	grid->rows = (int32_t)ceilf(height / cellSize);
+	grid->cellStart = NULL;
+	grid->cellItems = NULL;
+	grid->entryCount = 0;
+}
+
+static int32_t clampCell(int32_t value, int32_t max)
+{
+	return value < 0 ? 0 : (value > max ? max : value);
+}
+
+CellRange gridCellRange(const CollisionGrid *grid, Rectangle box)
+{
+	CellRange range;
+	range.minColumn = clampCell((int32_t)floorf(box.x * grid->invCellSize), grid->columns - 1);
+	range.minRow = clampCell((int32_t)floorf(box.y * grid->invCellSize), grid->rows - 1);
+	range.maxColumn = clampCell((int32_t)floorf((box.x + box.width) * grid->invCellSize), grid->columns - 1);
+	range.maxRow = clampCell((int32_t)floorf((box.y + box.height) * grid->invCellSize), grid->rows - 1);
+	return range;
+}
+
+// Bins boxes[0..count) by index. The cell arrays are pushed on arena, which
+// is expected to be scratch memory rewound once the tick's queries are done.
+// False, with the grid unusable, when the arena runs out.
+bool buildCollisionGrid(CollisionGrid *grid, MemoryArena *arena, const Rectangle *boxes, int32_t count)
+{
+	int32_t cellCount = grid->columns * grid->rows;
+	grid->cellStart = PushArray(arena, cellCount + 1, int32_t);
+	if (!grid->cellStart)
+	{
+		return false;
+	}
+
+	// count entries per cell, shifted by one so the prefix sum lands on starts
+	int32_t entries = 0;
+	for (int32_t i = 0; i < count; i++)
+	{
+		CellRange range = gridCellRange(grid, boxes[i]);
+		for (int32_t row = range.minRow; row <= range.maxRow; row++)
+		{
+			for (int32_t column = range.minColumn; column <= range.maxColumn; column++)
+			{
+				grid->cellStart[row * grid->columns + column + 1]++;
+				entries++;
+			}
+		}
+	}
+
+	for (int32_t cell = 0; cell < cellCount; cell++)
+	{
+		grid->cellStart[cell + 1] += grid->cellStart[cell];
+	}
+
+	grid->cellItems = PushArray(arena, entries, int32_t);
+	bool bounds = initColliderSoA(&grid->cellBounds, arena, entries);
+	grid->entryCount = entries;
+
+	int32_t *cursor = PushArray(arena, cellCount, int32_t);
+	if (!grid->cellItems || !bounds || !cursor)
+	{
+		return false;
+	}
+	memcpy(cursor, grid->cellStart, cellCount * sizeof(int32_t));
+	for (int32_t i = 0; i < count; i++)
+	{
+		CellRange range = gridCellRange(grid, boxes[i]);
+		for (int32_t row = range.minRow; row <= range.maxRow; row++)
+		{
+			for (int32_t column = range.minColumn; column <= range.maxColumn; column++)
+			{
+				int32_t entry = cursor[row * grid->columns + column]++;
+				grid->cellItems[entry] = i;
+				setCollider(&grid->cellBounds, entry, boxes[i]);
+			}
+		}
+	}
+	return true;
+}
+
+// Earliest live item hit by box moving through delta, ties to the lowest
+// index, so the answer does not depend on which cell reached the item first.
+SweepHit gridFirstSweptHit(const CollisionGrid *grid, const bool *alive, Rectangle box, Vector2 delta)
+{
+	uint32_t mask[OVERLAP_CHUNK / 32];
+	SweepHit best = { -1, 0.0f };
+	Rectangle swept = sweptBounds(box, delta);
+	CellRange range = gridCellRange(grid, swept);
+	for (int32_t row = range.minRow; row <= range.maxRow; row++)
+	{
+		for (int32_t column = range.minColumn; column <= range.maxColumn; column++)
+		{
+			int32_t cell = row * grid->columns + column;
+			for (int32_t first = grid->cellStart[cell]; first < grid->cellStart[cell + 1]; first += OVERLAP_CHUNK)
+			{
+				int32_t count = grid->cellStart[cell + 1] - first;
+				if (count > OVERLAP_CHUNK)
+				{
+					count = OVERLAP_CHUNK;
+				}
+
+				aabbOverlapMask(swept, &grid->cellBounds, first, count, mask);
+				for (int32_t word = 0; word < overlapMaskWords(count); word++)
+				{
+					for (uint32_t bits = mask[word]; bits; bits &= bits - 1)
+					{
+						int32_t entry = first + word * 32 + lowestBit(bits);
+						int32_t item = grid->cellItems[entry];
+						float toi;
+						if (alive[item] && sweepBounds(box, delta, &grid->cellBounds, entry, &toi))
+						{
+							takeEarlierHit(&best, item, toi);
+						}
+					}
+				}
+			}
+		}
+	}
+	return best;
+}
+
+bool checkCollision(Rectangle a, Rectangle b)
+{
+    return (a.x < b.x + b.width &&
+            a.x + a.width > b.x &&
+            a.y < b.y + b.height &&
+            a.y + a.height > b.y);
+}
@@ -0,0 +1,80 @@
+#ifndef COLLISION_H
+#define COLLISION_H
+
+#include "raylib.h"
+#include "arena.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+#define COLLISION_CELL_SIZE 64.0f
+// Below this many bullet x enemy pairs the grid costs more than it saves and
+// every pair is tested directly.
+#define COLLISION_ALL_PAIRS_LIMIT 4096
+// Arrays are padded by this many lanes so kernels may over-read the tail.
+#define COLLIDER_LANES 8
+
+// Packed box bounds for batch overlap tests. min/max rather than
+// position/size so each test is four compares and no adds.
+typedef struct ColliderSoA
+{
+	float *minX;
+	float *minY;
+	float *maxX;
+	float *maxY;
+	int32_t count;
+} ColliderSoA;
+
+// Uniform grid over the playfield, rebuilt from scratch every tick. Items
+// are binned into every cell their box touches with a counting sort, so the
+// entries of cell c are cellItems[cellStart[c] .. cellStart[c + 1]), with
+// their bounds packed in the same order in cellBounds. Boxes outside the
+// playfield are clamped into the border cells.
+typedef struct CollisionGrid
+{
+	float cellSize;
+	float invCellSize;
+	int32_t columns;
+	int32_t rows;
+
+	int32_t *cellStart;
+	int32_t *cellItems;
+	ColliderSoA cellBounds;
+	int32_t entryCount;
+} CollisionGrid;
+
+// Result of a swept query: item is -1 on a miss, toi the fraction of the
+// tick's motion at first contact.
+typedef struct SweepHit
+{
+	int32_t item;
+	float toi;
+} SweepHit;
+
+// Inclusive range of cells a box overlaps.
+typedef struct CellRange
+{
+	int32_t minColumn;
+	int32_t minRow;
+	int32_t maxColumn;
+	int32_t maxRow;
+} CellRange;
+
+//functions==================
+//
+bool initColliderSoA(ColliderSoA *colliders, MemoryArena *arena, int32_t count);
+void setCollider(ColliderSoA *colliders, int32_t index, Rectangle box);
+void aabbOverlapMask(Rectangle box, const ColliderSoA *colliders, int32_t first, int32_t count, uint32_t *mask);
+void aabbOverlapAllPairs(const ColliderSoA *a, const ColliderSoA *b, uint32_t *masks);
+int32_t overlapMaskWords(int32_t count);
+bool sweptAabb(Rectangle box, Vector2 delta, Rectangle target, float *toi);
+Rectangle sweptBounds(Rectangle box, Vector2 delta);
+SweepHit firstSweptHit(const uint32_t *mask, int32_t words, const bool *alive, const ColliderSoA *bounds, Rectangle box, Vector2 delta);
+void initCollisionGrid(CollisionGrid *grid, float width, float height, float cellSize);
+bool buildCollisionGrid(CollisionGrid *grid, MemoryArena *arena, const Rectangle *boxes, int32_t count);
+CellRange gridCellRange(const CollisionGrid *grid, Rectangle box);
+SweepHit gridFirstSweptHit(const CollisionGrid *grid, const bool *alive, Rectangle box, Vector2 delta);
+bool checkCollision(Rectangle a, Rectangle b);
+//
+//===========================
+
+#endif
@@ -0,0 +1,20 @@
+#include "game.h"
+
+// The one entry point the host looks up in game.so. Builds without hot
+// reload link this same file into the executable.
+void GameUpdateAndRender(GameMemory *memory, GameInput *input)
+{
+	// module globals start empty after a reload; the host's logger is the one
+	setActiveLogger(memory->logger);
+
+	SimStep(memory, &input->frame, input->dt);
+
+	if (input->commands)
+	{
+		State *state = (State *)memory->PermanantStorage;
+		beginProfilePhase(memory->profiler, PROFILE_SIM_RECORD);
+		recordRenderCommands(state, input->commands, input->showColliders, input->dt);
+		sortRenderCommands(input->commands, &transientState(memory)->frameArena);
+		endProfilePhase(memory->profiler, PROFILE_SIM_RECORD);
+	}
+}
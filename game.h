@@ -0,0 +1,41 @@
+#ifndef GAME_H
+#define GAME_H
+
+#include "sim.h"
+#include "render_commands.h"
+#include <stdbool.h>
+
+// Boundary between the platform host and the gameplay code. The host owns
+// the window, threads, job system and logger and calls GameUpdateAndRender
+// once per tick; everything the game keeps between calls lives in
+// GameMemory. That lets the host build the gameplay code as a separate
+// module (game.so) and swap it between two ticks without losing the session.
+//
+// The memory must already hold an initialised State (initState).
+
+#if defined(_WIN32)
+#    define GAME_EXPORT __declspec(dllexport)
+#else
+#    define GAME_EXPORT __attribute__((visibility("default")))
+#endif
+
+#define GAME_UPDATE_AND_RENDER_NAME "GameUpdateAndRender"
+
+typedef struct GameInput
+{
+	InputFrame frame;
+	float dt;
+	// when set, the tick ends by recording its sorted draw list into it
+	RenderCommandBuffer *commands;
+	bool showColliders;
+} GameInput;
+
+typedef void GameUpdateAndRenderFn(GameMemory *memory, GameInput *input);
+
+//functions==================
+//
+GAME_EXPORT void GameUpdateAndRender(GameMemory *memory, GameInput *input);
+//
+//===========================
+
+#endif
@@ -0,0 +1,124 @@
+#include "game_code.h"
+#include "logger.h"
+#include "platform.h"
+#include <stdio.h>
+
+static bool loadGameModule(GameCode *code, int64_t writeTime)
+{
+	int32_t slot = code->library ? 1 - code->loadedSlot : code->loadedSlot;
+	const char *copy = code->loadedPath[slot];
+	if (!platformCopyFile(code->path, copy))
+	{
+		logMessage(LOG_LEVEL_WARNING, LOG_CATEGORY_GENERAL, "could not copy %s to %s", code->path, copy);
+		return false;
+	}
+	void *library = platformLoadLibrary(copy);
+	GameUpdateAndRenderFn *updateAndRender = library
+		? (GameUpdateAndRenderFn *)platformLibrarySymbol(library, GAME_UPDATE_AND_RENDER_NAME)
+		: NULL;
+	if (!updateAndRender)
+	{
+		logMessage(LOG_LEVEL_WARNING, LOG_CATEGORY_GENERAL, "%s has no usable %s, keeping the current code",
+			code->path, GAME_UPDATE_AND_RENDER_NAME);
+		if (library)
+		{
+			platformUnloadLibrary(library);
+		}
+		return false;
+	}
+
+	// the old module is only dropped once the new one is known to work
+	if (code->library)
+	{
+		platformUnloadLibrary(code->library);
+	}
+	code->library = library;
+	code->updateAndRender = updateAndRender;
+	code->loadedSlot = slot;
+	code->loadedWriteTime = writeTime;
+	return true;
+}
+
+// With path NULL this only sets up the linked-in code. Returns false if the
+// module could not be loaded; the linked-in code runs until it can be.
+bool initGameCode(GameCode *code, const char *path)
+{
+	code->updateAndRender = GameUpdateAndRender;
+	code->path = path;
+	code->library = NULL;
+	code->loadedSlot = 0;
+	code->loadedWriteTime = 0;
+	code->pendingWriteTime = 0;
+	code->pendingSince = 0.0;
+	code->reloadCount = 0;
+	if (!path)
+	{
+		return true;
+	}
+
+	for (int32_t slot = 0; slot < 2; slot++)
+	{
+		snprintf(code->loadedPath[slot], GAME_CODE_PATH_MAX, "%s.live%d", path, slot);
+	}
+	int64_t writeTime = platformFileWriteTime(path);
+	if (writeTime == 0 || !loadGameModule(code, writeTime))
+	{
+		logMessage(LOG_LEVEL_WARNING, LOG_CATEGORY_GENERAL, "could not load %s, running the linked-in game code", path);
+		// still reload it once a build appears
+		code->loadedWriteTime = writeTime;
+		return false;
+	}
+	logMessage(LOG_LEVEL_INFO, LOG_CATEGORY_GENERAL, "game code loaded from %s", path);
+	return true;
+}
+
+// Cheap enough to call every frame: one stat of the module unless a new
+// build is waiting to settle. Returns true when new code was swapped in.
+bool reloadGameCodeIfChanged(GameCode *code)
+{
+	if (!code->path)
+	{
+		return false;
+	}
+
+	int64_t writeTime = platformFileWriteTime(code->path);
+	if (writeTime == 0 || writeTime == code->loadedWriteTime)
+	{
+		return false;
+	}
+	double now = platformGetSeconds();
+	if (writeTime != code->pendingWriteTime)
+	{
+		code->pendingWriteTime = writeTime;
+		code->pendingSince = now;
+		return false;
+	}
+	if (now - code->pendingSince < GAME_RELOAD_SETTLE)
+	{
+		return false;
+	}
+
+	if (!loadGameModule(code, writeTime))
+	{
+		// not again until the build writes another one
+		code->loadedWriteTime = writeTime;
+		return false;
+	}
+	code->reloadCount++;
+	logMessage(LOG_LEVEL_INFO, LOG_CATEGORY_GENERAL, "game code reloaded from %s (reload %d)", code->path, code->reloadCount);
+	return true;
+}
+
+void unloadGameCode(GameCode *code)
+{
+	if (code->library)
+	{
+		platformUnloadLibrary(code->library);
+		code->library = NULL;
+		for (int32_t slot = 0; slot < 2; slot++)
+		{
+			remove(code->loadedPath[slot]);
+		}
+	}
+	code->updateAndRender = GameUpdateAndRender;
+}
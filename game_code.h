@@ -0,0 +1,47 @@
+#ifndef GAME_CODE_H
+#define GAME_CODE_H
+
+#include "game.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+// Host side of hot reload. The gameplay code starts out as the copy linked
+// into the executable; given a module path it runs from that module instead
+// and reloads it whenever the build writes a new one.
+//
+// The module is copied before it is opened so the build can overwrite it
+// while it is in use, and a new build is only picked up once its write time
+// has held still for GAME_RELOAD_SETTLE, so a half-written file is never
+// opened. Only the thread that calls updateAndRender may reload, between two
+// calls; no other thread runs module code outside of them.
+
+#define GAME_RELOAD_SETTLE 0.25
+#define GAME_CODE_PATH_MAX 512
+
+typedef struct GameCode
+{
+	GameUpdateAndRenderFn *updateAndRender;
+
+	// NULL when running the linked-in code
+	const char *path;
+	void *library;
+	// the two copies are used in turn, so a new one never replaces the file
+	// still mapped
+	char loadedPath[2][GAME_CODE_PATH_MAX];
+	int32_t loadedSlot;
+	int64_t loadedWriteTime;
+
+	int64_t pendingWriteTime;
+	double pendingSince;
+	int32_t reloadCount;
+} GameCode;
+
+//functions==================
+//
+bool initGameCode(GameCode *code, const char *path);
+bool reloadGameCodeIfChanged(GameCode *code);
+void unloadGameCode(GameCode *code);
+//
+//===========================
+
+#endif
@@ -0,0 +1,548 @@
+#include "sim.h"
+#include "game_code.h"
+#include "platform.h"
+#include "replay.h"
+#include "snapshot.h"
+#include "logger.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Runs the simulation without a window, as fast as the CPU allows, with a
+// scripted input pattern. Used for soak tests and for benchmarking gameplay
+// logic on machines without a GPU or display.
+//
+// --spray keeps that many extra bullets in flight and revives the wave every
+// tick, so a stress run holds a constant load instead of clearing the screen.
+// --scale repeats the run on 1, 2, 4 ... up to --workers workers and prints
+// how the tick rate scales.
+//
+// --replay runs a recorded session instead of the script, with the config,
+// seed and tick rate it was recorded with, and fails if the final state hash
+// differs from the recording's. --record writes the scripted run out as a
+// replay.
+//
+// --game runs the ticks through a game module instead of the linked-in code
+// and reloads it when it is rebuilt, so a long soak can pick up a change
+// without restarting.
+//
+// --load-state starts the run from a save state instead of a fresh state,
+// with the scripted input picking up at the tick it was saved on, so a perf
+// problem caught in a long session can be run again straight away.
+// --save-state writes one out at the end of the run.
+//
+// --profile times every sim phase, writes a CSV row of p50 / p99 per phase
+// once per simulated second and prints the totals at the end.
+
+#define DEFAULT_TICKS 100000
+// well clear of the per-wave streams
+#define SPRAY_RNG_STREAM (1ull << 32)
+#define LOG_ARENA_SIZE Megabytes(1)
+
+typedef struct HeadlessRun
+{
+	SimConfig config;
+	int64_t ticks;
+	int hz;
+	int32_t workers;
+	int32_t spray;
+	// input source when set, otherwise scriptedInput
+	const ReplayReader *replay;
+	const char *recordPath;
+	const char *profilePath;
+	// NULL runs the linked-in game code
+	GameCode *code;
+	const char *loadStatePath;
+	const char *saveStatePath;
+} HeadlessRun;
+
+typedef struct HeadlessResult
+{
+	double elapsed;
+	int32_t bullets;
+	int32_t enemiesAlive;
+	uint64_t hash;
+	bool ok;
+} HeadlessResult;
+
+//functions==================
+//
+InputFrame scriptedInput(int64_t tick, int hz);
+void sprayBullets(State *state, MemoryArena *scratch, RngLanes *lanes, int32_t target);
+void reportProfile(const Profiler *profiler);
+HeadlessResult runHeadless(const HeadlessRun *run, bool report);
+bool parseCount(const char *flag, const char *text, int32_t min, int32_t max, int32_t *value);
+//
+//===========================
+
+static GameMemory gameMemory = {0};
+int main(int argc, char **argv)
+{
+	HeadlessRun run = {0};
+	run.config = defaultSimConfig();
+	run.ticks = DEFAULT_TICKS;
+	run.hz = SIM_HZ;
+	run.workers = 1;
+	bool scale = false;
+	const char *replayPath = NULL;
+	const char *logPath = NULL;
+	const char *gamePath = NULL;
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "--ticks") == 0 && i + 1 < argc)
+		{
+			run.ticks = strtoll(argv[++i], NULL, 10);
+		}
+		else if (strcmp(argv[i], "--hz") == 0 && i + 1 < argc)
+		{
+			run.hz = (int)strtol(argv[++i], NULL, 10);
+		}
+		else if (strcmp(argv[i], "--bullets") == 0 && i + 1 < argc)
+		{
+			if (!parseCount("--bullets", argv[++i], 1, SIM_MAX_BULLETS, &run.config.bulletCapacity))
+			{
+				return 1;
+			}
+		}
+		else if (strcmp(argv[i], "--waves") == 0 && i + 1 < argc)
+		{
+			if (!parseCount("--waves", argv[++i], 1, SIM_MAX_ENEMIES, &run.config.waveCount))
+			{
+				return 1;
+			}
+		}
+		else if (strcmp(argv[i], "--enemies") == 0 && i + 1 < argc)
+		{
+			if (!parseCount("--enemies", argv[++i], 1, SIM_MAX_ENEMIES, &run.config.enemyCount))
+			{
+				return 1;
+			}
+		}
+		else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc)
+		{
+			run.config.seed = (uint32_t)strtoul(argv[++i], NULL, 10);
+		}
+		else if (strcmp(argv[i], "--spray") == 0 && i + 1 < argc)
+		{
+			if (!parseCount("--spray", argv[++i], 0, SIM_MAX_BULLETS, &run.spray))
+			{
+				return 1;
+			}
+		}
+		else if (strcmp(argv[i], "--workers") == 0 && i + 1 < argc)
+		{
+			run.workers = (int32_t)strtol(argv[++i], NULL, 10);
+			if (run.workers <= 0)
+			{
+				run.workers = platformCpuCount();
+			}
+		}
+		else if (strcmp(argv[i], "--scale") == 0)
+		{
+			scale = true;
+		}
+		else if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc)
+		{
+			replayPath = argv[++i];
+		}
+		else if (strcmp(argv[i], "--record") == 0 && i + 1 < argc)
+		{
+			run.recordPath = argv[++i];
+		}
+		else if (strcmp(argv[i], "--log") == 0 && i + 1 < argc)
+		{
+			logPath = argv[++i];
+		}
+		else if (strcmp(argv[i], "--profile") == 0 && i + 1 < argc)
+		{
+			run.profilePath = argv[++i];
+		}
+		else if (strcmp(argv[i], "--game") == 0 && i + 1 < argc)
+		{
+			gamePath = argv[++i];
+		}
+		else if (strcmp(argv[i], "--load-state") == 0 && i + 1 < argc)
+		{
+			run.loadStatePath = argv[++i];
+		}
+		else if (strcmp(argv[i], "--save-state") == 0 && i + 1 < argc)
+		{
+			run.saveStatePath = argv[++i];
+		}
+		else
+		{
+			fprintf(stderr, "usage: %s [--ticks N] [--hz TICKRATE] [--bullets CAPACITY] [--waves N]\n"
+				"       [--enemies PER_WAVE] [--seed N] [--spray BULLETS] [--workers N (0 = all cores)] [--scale]\n"
+				"       [--replay REPLAY | --record REPLAY] [--log FILE (everything from debug up)]\n"
+				"       [--profile CSV] [--game MODULE (hot reloaded)] [--load-state FILE] [--save-state FILE]\n", argv[0]);
+			return 1;
+		}
+	}
+
+	// sprayed bullets and revived enemies are not part of the input stream
+	if ((replayPath || run.recordPath) && run.spray > 0)
+	{
+		fprintf(stderr, "--spray cannot be recorded or replayed\n");
+		return 1;
+	}
+	if (replayPath && run.recordPath)
+	{
+		fprintf(stderr, "--replay and --record are exclusive\n");
+		return 1;
+	}
+	// a replay starts from a fresh state at tick 0
+	if ((replayPath || run.recordPath) && run.loadStatePath)
+	{
+		fprintf(stderr, "--load-state cannot be recorded or replayed\n");
+		return 1;
+	}
+	if (scale && run.profilePath)
+	{
+		fprintf(stderr, "--profile profiles a single run, not --scale\n");
+		return 1;
+	}
+
+	ReplayReader replay = {0};
+	if (replayPath)
+	{
+		if (!loadReplay(&replay, replayPath))
+		{
+			fprintf(stderr, "could not read replay %s: missing, damaged or sized past what the game memory holds\n", replayPath);
+			return 1;
+		}
+		run.replay = &replay;
+		run.config = replayConfig(&replay.header);
+		run.hz = replay.header.hz;
+		run.ticks = (int64_t)replay.header.tickCount;
+	}
+
+	if (run.hz <= 0)
+	{
+		fprintf(stderr, "--hz must be positive\n");
+		return 1;
+	}
+	if (!replayPath && !validSimConfig(&run.config))
+	{
+		fprintf(stderr, "--waves times --enemies must be at most %d\n", SIM_MAX_ENEMIES);
+		return 1;
+	}
+	if (run.spray > run.config.bulletCapacity)
+	{
+		run.config.bulletCapacity = run.spray;
+	}
+
+	gameMemory.PermanantStorageSize = PERMANENT_STORAGE_SIZE;
+	gameMemory.TransientStorageSize = TRANSIENT_STORAGE_SIZE;
+	gameMemory.PermanantStorage = calloc(1, gameMemory.PermanantStorageSize);
+	gameMemory.TransientStorage = calloc(1, gameMemory.TransientStorageSize);
+
+	if (!gameMemory.PermanantStorage || !gameMemory.TransientStorage)
+	{
+		return -1; // Failed to allocate memory
+	}
+
+	// the logger outlives every run, so it gets memory of its own
+	Logger logger = {0};
+	void *logMemory = NULL;
+	if (logPath)
+	{
+		MemoryArena logArena;
+		logMemory = malloc(LOG_ARENA_SIZE);
+		if (!logMemory)
+		{
+			return -1;
+		}
+		initArena(&logArena, "log", logMemory, LOG_ARENA_SIZE);
+		if (!initLogger(&logger, &logArena, LOG_DEFAULT_CAPACITY, logPath, LOG_LEVEL_DEBUG))
+		{
+			fprintf(stderr, "could not open %s\n", logPath);
+			return 1;
+		}
+		startLogger(&logger);
+		setActiveLogger(&logger);
+		gameMemory.logger = &logger;
+	}
+
+	GameCode code;
+	if (gamePath)
+	{
+		if (!initGameCode(&code, gamePath))
+		{
+			fprintf(stderr, "could not load %s, running the linked-in game code until it builds\n", gamePath);
+		}
+		run.code = &code;
+	}
+
+	bool ok = true;
+	if (scale)
+	{
+		int32_t maxWorkers = run.workers > 1 ? run.workers : platformCpuCount();
+		printf("%8s %12s %10s %8s %10s %8s\n", "workers", "ticks/s", "us/tick", "speedup", "bullets", "enemies");
+		double baseline = 0.0;
+		for (int32_t workers = 1; ; workers *= 2)
+		{
+			if (workers > maxWorkers)
+			{
+				workers = maxWorkers;
+			}
+			HeadlessRun step = run;
+			step.workers = workers;
+			HeadlessResult result = runHeadless(&step, false);
+			ok = ok && result.ok;
+			if (workers == 1)
+			{
+				baseline = result.elapsed;
+			}
+			printf("%8d %12.0f %10.3f %7.2fx %10d %8d\n", workers,
+				result.elapsed > 0.0 ? run.ticks / result.elapsed : 0.0,
+				run.ticks > 0 ? result.elapsed * 1e6 / run.ticks : 0.0,
+				result.elapsed > 0.0 ? baseline / result.elapsed : 0.0,
+				result.bullets, result.enemiesAlive);
+			if (workers == maxWorkers)
+			{
+				break;
+			}
+		}
+	}
+	else
+	{
+		ok = runHeadless(&run, true).ok;
+	}
+
+	if (gamePath)
+	{
+		unloadGameCode(&code);
+	}
+	if (logPath)
+	{
+		gameMemory.logger = NULL;
+		setActiveLogger(NULL);
+		stopLogger(&logger);
+		free(logMemory);
+	}
+	unloadReplay(&replay);
+	free(gameMemory.PermanantStorage);
+	free(gameMemory.TransientStorage);
+
+	return ok ? 0 : 1;
+}
+
+// A whole decimal number from min to max; anything else is reported against flag.
+bool parseCount(const char *flag, const char *text, int32_t min, int32_t max, int32_t *value)
+{
+	char *end;
+	long long parsed = strtoll(text, &end, 10);
+	if (end == text || *end != '\0' || parsed < min || parsed > max)
+	{
+		fprintf(stderr, "%s takes a number from %d to %d, not %s\n", flag, min, max, text);
+		return false;
+	}
+	*value = (int32_t)parsed;
+	return true;
+}
+
+// One run from a fresh state, or the --load-state one. The job system is carved from the transient
+// arena after the sim's own allocations and torn down before returning.
+HeadlessResult runHeadless(const HeadlessRun *run, bool report)
+{
+	gameMemory.IsInitialised = false;
+	State *state = initState(&gameMemory, &run->config);
+	HeadlessResult result = {0};
+	if (!state)
+	{
+		fprintf(stderr, "game memory too small for %d waves of %d enemies and %d bullets\n",
+			run->config.waveCount, run->config.enemyCount, run->config.bulletCapacity);
+		return result;
+	}
+
+	JobSystem jobs;
+	initJobSystem(&jobs, &transientState(&gameMemory)->transientArena, run->workers);
+	gameMemory.jobs = &jobs;
+
+	result.ok = true;
+	int64_t firstTick = 0;
+	if (run->loadStatePath)
+	{
+		double loadStart = platformGetSeconds();
+		if (!readSnapshotFile(&gameMemory, run->loadStatePath, &firstTick))
+		{
+			fprintf(stderr, "could not load state %s\n", run->loadStatePath);
+			result.ok = false;
+		}
+		else if (report)
+		{
+			printf("loaded %zu bytes of state at tick %lld in %.1f us\n", snapshotSize(&gameMemory),
+				(long long)firstTick, (platformGetSeconds() - loadStart) * 1e6);
+		}
+	}
+	ReplayReader replay = {0};
+	if (run->replay)
+	{
+		// fresh cursor over the shared file data
+		replay = *run->replay;
+	}
+	ReplayWriter recorder = {0};
+	if (run->recordPath && !openReplayWriter(&recorder, run->recordPath, &run->config, run->hz))
+	{
+		fprintf(stderr, "could not open %s for recording\n", run->recordPath);
+		result.ok = false;
+	}
+
+	Profiler profiler;
+	FILE *profileCsv = NULL;
+	if (run->profilePath)
+	{
+		profileCsv = fopen(run->profilePath, "w");
+		if (!profileCsv)
+		{
+			fprintf(stderr, "could not open %s for profiling\n", run->profilePath);
+			result.ok = false;
+		}
+		else
+		{
+			initProfiler(&profiler);
+			writeProfileCsvHeader(profileCsv);
+			gameMemory.profiler = &profiler;
+		}
+	}
+
+	Rng seeder;
+	RngLanes sprayRng;
+	seedRng(&seeder, run->config.seed, SPRAY_RNG_STREAM);
+	seedRngLanes(&sprayRng, &seeder);
+
+	GameUpdateAndRenderFn *updateAndRender = run->code ? run->code->updateAndRender : GameUpdateAndRender;
+	float dt = 1.0f / run->hz;
+	double start = platformGetSeconds();
+	for (int64_t tick = firstTick; tick < firstTick + run->ticks && result.ok; tick++)
+	{
+		beginFrameScratch(&gameMemory);
+		if (run->spray > 0)
+		{
+			sprayBullets(state, &transientState(&gameMemory)->frameArena, &sprayRng, run->spray);
+		}
+
+		InputFrame input = scriptedInput(tick, run->hz);
+		if (run->replay && !nextReplayInput(&replay, &input))
+		{
+			fprintf(stderr, "replay ended early at tick %lld\n", (long long)tick);
+			result.ok = false;
+			break;
+		}
+		recordReplayInput(&recorder, &input);
+		GameInput gameInput = {0};
+		gameInput.frame = input;
+		gameInput.dt = dt;
+		updateAndRender(&gameMemory, &gameInput);
+		if (run->code && (tick + 1) % run->hz == 0)
+		{
+			reloadGameCodeIfChanged(run->code);
+			updateAndRender = run->code->updateAndRender;
+		}
+
+		if (profileCsv && (tick + 1) % run->hz == 0)
+		{
+			writeProfileCsvRow(profileCsv, &profiler, (tick + 1) * (double)dt);
+		}
+	}
+	result.elapsed = platformGetSeconds() - start;
+	result.hash = hashState(state);
+	if (run->saveStatePath && !writeSnapshotFile(&gameMemory, firstTick + run->ticks, run->saveStatePath))
+	{
+		fprintf(stderr, "could not save state to %s\n", run->saveStatePath);
+		result.ok = false;
+	}
+	if (run->recordPath)
+	{
+		result.ok = closeReplayWriter(&recorder, result.hash) && result.ok;
+	}
+	if (run->replay && result.hash != run->replay->header.finalHash)
+	{
+		fprintf(stderr, "replay diverged: final hash %016llx, recorded %016llx\n",
+			(unsigned long long)result.hash, (unsigned long long)run->replay->header.finalHash);
+		result.ok = false;
+	}
+
+	int32_t workers = jobs.workerCount;
+	shutdownJobSystem(&jobs);
+	gameMemory.jobs = NULL;
+	gameMemory.profiler = NULL;
+
+	result.bullets = state->playerBullets.count;
+	const Enemy *enemies = stateEnemies(state);
+	for (int32_t i = 0; i < state->enemyCount; i++)
+	{
+		result.enemiesAlive += enemies[i].active;
+	}
+
+	if (report)
+	{
+		printf("ticks: %lld  simulated: %.1fs  wall: %.3fs  ticks/s: %.0f  us/tick: %.3f  workers: %d\n",
+			(long long)run->ticks, run->ticks * dt, result.elapsed,
+			result.elapsed > 0.0 ? run->ticks / result.elapsed : 0.0,
+			run->ticks > 0 ? result.elapsed * 1e6 / run->ticks : 0.0,
+			workers);
+		printf("state hash: %016llx\n", (unsigned long long)result.hash);
+		reportMemory(&gameMemory);
+	}
+	if (profileCsv)
+	{
+		if (report)
+		{
+			reportProfile(&profiler);
+		}
+		fclose(profileCsv);
+	}
+	return result;
+}
+
+// p50 / p99 of the last PROFILE_WINDOW ticks for each sim phase.
+void reportProfile(const Profiler *profiler)
+{
+	printf("%-14s %10s %10s\n", "phase", "p50 us", "p99 us");
+	for (int phase = 0; phase < PROFILE_SIM_RECORD; phase++)
+	{
+		ProfileStats stats = profilePhaseStats(profiler, (ProfilePhase)phase);
+		printf("%-14s %10.2f %10.2f\n", profilePhaseName((ProfilePhase)phase), stats.p50 * 1000.0f, stats.p99 * 1000.0f);
+	}
+}
+
+// Sweeps left and right across the screen firing every few ticks, which keeps
+// the bullet pool and the wave movement busy for the whole run.
+InputFrame scriptedInput(int64_t tick, int hz)
+{
+	InputFrame input = {0};
+	input.buttons |= ((tick / (2 * hz)) % 2) ? INPUT_LEFT : INPUT_RIGHT;
+	if (tick % (hz / 15 > 0 ? hz / 15 : 1) == 0)
+	{
+		input.buttons |= INPUT_SHOOT;
+	}
+	return input;
+}
+
+// Tops the pool up to target bullets at random points along the bottom of
+// the screen and brings every enemy in every wave back. Seeded from the run's seed so runs
+// with different worker counts do identical work.
+void sprayBullets(State *state, MemoryArena *scratch, RngLanes *lanes, int32_t target)
+{
+	BulletPool *bullets = &state->playerBullets;
+	int32_t missing = target - bullets->count;
+	if (missing > 0)
+	{
+		float *xs = PushArray(scratch, missing, float);
+		fillRandomFloats(lanes, xs, missing, 0.0f, SCREENWIGTH);
+		for (int32_t i = 0; i < missing; i++)
+		{
+			if (spawnBullet(bullets, (Vector2){ xs[i], SCREENHEIGTH }, (Vector2){ 0, -BULLET_SPEED }) < 0)
+			{
+				break;
+			}
+		}
+	}
+
+	Enemy *enemies = stateEnemies(state);
+	for (int32_t i = 0; i < state->enemyCount; i++)
+	{
+		enemies[i].active = true;
+	}
+}
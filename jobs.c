@@ -0,0 +1,211 @@
+#include "jobs.h"
+
+// Which queue the current thread owns. Threads the system did not start,
+// including the one that created it, are worker 0.
+static _Thread_local int32_t currentWorker = 0;
+
+static void lockQueue(JobQueue *queue)
+{
+	while (atomic_flag_test_and_set_explicit(&queue->lock, memory_order_acquire))
+	{
+	}
+}
+
+static void unlockQueue(JobQueue *queue)
+{
+	atomic_flag_clear_explicit(&queue->lock, memory_order_release);
+}
+
+static bool pushQueue(JobQueue *queue, const Job *job)
+{
+	bool pushed = false;
+	lockQueue(queue);
+	if (queue->bottom - queue->top < JOB_QUEUE_CAPACITY)
+	{
+		queue->jobs[queue->bottom & (JOB_QUEUE_CAPACITY - 1)] = *job;
+		queue->bottom++;
+		pushed = true;
+	}
+	unlockQueue(queue);
+	return pushed;
+}
+
+// Owner end: newest first, so a worker keeps going on what it just split.
+static bool popQueue(JobQueue *queue, Job *job)
+{
+	bool popped = false;
+	lockQueue(queue);
+	if (queue->bottom > queue->top)
+	{
+		queue->bottom--;
+		*job = queue->jobs[queue->bottom & (JOB_QUEUE_CAPACITY - 1)];
+		popped = true;
+	}
+	unlockQueue(queue);
+	return popped;
+}
+
+// Thief end: oldest first, which for a split range is the furthest from
+// what the owner is working on.
+static bool stealQueue(JobQueue *queue, Job *job)
+{
+	bool stolen = false;
+	lockQueue(queue);
+	if (queue->bottom > queue->top)
+	{
+		*job = queue->jobs[queue->top & (JOB_QUEUE_CAPACITY - 1)];
+		queue->top++;
+		stolen = true;
+	}
+	unlockQueue(queue);
+	return stolen;
+}
+
+static void runJob(const Job *job)
+{
+	job->proc(job->data, job->begin, job->end);
+	atomic_fetch_sub_explicit(&job->counter->pending, 1, memory_order_release);
+}
+
+// Runs one job from this worker's queue, or failing that one stolen from
+// another worker. Returns false if there was nothing to do anywhere.
+static bool runOneJob(JobSystem *jobs, int32_t self)
+{
+	Job job;
+	if (popQueue(&jobs->queues[self], &job))
+	{
+		runJob(&job);
+		return true;
+	}
+	for (int32_t i = 1; i < jobs->workerCount; i++)
+	{
+		int32_t victim = (self + i) % jobs->workerCount;
+		if (stealQueue(&jobs->queues[victim], &job))
+		{
+			runJob(&job);
+			return true;
+		}
+	}
+	return false;
+}
+
+static int jobWorkerProc(void *data)
+{
+	JobWorker *worker = (JobWorker *)data;
+	JobSystem *jobs = worker->system;
+	currentWorker = worker->index;
+
+	// spin briefly between bursts of work (the next tick is usually close),
+	// then back off to sleeping so an idle game does not burn cores
+	int32_t idle = 0;
+	while (!atomic_load_explicit(&jobs->quit, memory_order_acquire))
+	{
+		if (runOneJob(jobs, worker->index))
+		{
+			idle = 0;
+		}
+		else if (++idle < 256)
+		{
+			platformYieldThread();
+		}
+		else
+		{
+			platformSleepSeconds(0.0005);
+		}
+	}
+	return 0;
+}
+
+// workerCount counts the calling thread; 1 runs everything inline.
+void initJobSystem(JobSystem *jobs, MemoryArena *arena, int32_t workerCount)
+{
+	if (workerCount < 1)
+	{
+		workerCount = 1;
+	}
+	if (workerCount > JOB_MAX_WORKERS)
+	{
+		workerCount = JOB_MAX_WORKERS;
+	}
+
+	jobs->workerCount = workerCount;
+	jobs->queues = PushArray(arena, workerCount, JobQueue);
+	jobs->workers = PushArray(arena, workerCount, JobWorker);
+	atomic_init(&jobs->quit, false);
+	for (int32_t i = 0; i < workerCount; i++)
+	{
+		atomic_flag_clear(&jobs->queues[i].lock);
+		jobs->queues[i].jobs = PushArray(arena, JOB_QUEUE_CAPACITY, Job);
+		jobs->workers[i].system = jobs;
+		jobs->workers[i].index = i;
+	}
+
+	for (int32_t i = 1; i < workerCount; i++)
+	{
+		if (!platformStartThread(&jobs->workers[i].thread, jobWorkerProc, &jobs->workers[i]))
+		{
+			// run with the workers that did start
+			jobs->workerCount = i;
+			break;
+		}
+	}
+}
+
+// Call with no jobs in flight.
+void shutdownJobSystem(JobSystem *jobs)
+{
+	atomic_store_explicit(&jobs->quit, true, memory_order_release);
+	for (int32_t i = 1; i < jobs->workerCount; i++)
+	{
+		platformJoinThread(&jobs->workers[i].thread);
+	}
+	jobs->workerCount = 1;
+}
+
+// Queues proc over [begin, end) on the calling worker. Runs it straight away
+// if the queue is full.
+void pushJob(JobSystem *jobs, JobProc proc, void *data, int32_t begin, int32_t end, JobCounter *counter)
+{
+	Job job = { proc, data, begin, end, counter };
+	atomic_fetch_add_explicit(&counter->pending, 1, memory_order_relaxed);
+	if (!pushQueue(&jobs->queues[currentWorker], &job))
+	{
+		runJob(&job);
+	}
+}
+
+// Splits [0, count) into jobs of grain items (the last may be shorter).
+// With no job system, a single worker or a single grain the whole range runs
+// inline, so serial callers pay nothing. Wait on counter before using the
+// results.
+void parallelFor(JobSystem *jobs, JobProc proc, void *data, int32_t count, int32_t grain, JobCounter *counter)
+{
+	if (count <= 0)
+	{
+		return;
+	}
+	if (!jobs || jobs->workerCount <= 1 || count <= grain)
+	{
+		proc(data, 0, count);
+		return;
+	}
+
+	for (int32_t begin = 0; begin < count; begin += grain)
+	{
+		int32_t end = (count - begin > grain) ? begin + grain : count;
+		pushJob(jobs, proc, data, begin, end, counter);
+	}
+}
+
+// Returns once every job counted on counter has finished, helping with
+// queued work in the meantime.
+void waitForJobs(JobSystem *jobs, JobCounter *counter)
+{
+	while (atomic_load_explicit(&counter->pending, memory_order_acquire) > 0)
+	{
+		if (!runOneJob(jobs, currentWorker))
+		{
+			platformYieldThread();
+		}
+	}
+}
@@ -0,0 +1,76 @@
+#ifndef JOBS_H
+#define JOBS_H
+
+#include "arena.h"
+#include "platform.h"
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+// Work-stealing job scheduler. Every worker owns a deque: it pushes and pops
+// its own jobs at the bottom while idle workers steal from the top of
+// someone else's. A job is a function over an index range; parallelFor cuts
+// a range into grain-sized jobs. Jobs report completion on a JobCounter, and
+// a system that depends on another waits for that counter, running queued
+// jobs itself while it waits rather than blocking.
+//
+// Worker 0 is the thread that created the system (the sim thread); the
+// other workerCount - 1 are started here.
+
+#define JOB_MAX_WORKERS 64
+#define JOB_QUEUE_CAPACITY 1024
+
+typedef void (*JobProc)(void *data, int32_t begin, int32_t end);
+
+typedef struct JobCounter
+{
+	_Atomic int32_t pending;
+} JobCounter;
+
+typedef struct Job
+{
+	JobProc proc;
+	void *data;
+	int32_t begin;
+	int32_t end;
+	JobCounter *counter;
+} Job;
+
+// Ring of jobs guarded by a spin lock; top and bottom only ever grow and
+// wrap through the mask. Aligned so neighbouring queues never share a line.
+typedef struct JobQueue
+{
+	_Alignas(64) atomic_flag lock;
+	int32_t top;
+	int32_t bottom;
+	Job *jobs;
+} JobQueue;
+
+struct JobSystem;
+
+typedef struct JobWorker
+{
+	struct JobSystem *system;
+	int32_t index;
+	PlatformThread thread;
+} JobWorker;
+
+typedef struct JobSystem
+{
+	JobQueue *queues;
+	JobWorker *workers;
+	int32_t workerCount;
+	atomic_bool quit;
+} JobSystem;
+
+//functions==================
+//
+void initJobSystem(JobSystem *jobs, MemoryArena *arena, int32_t workerCount);
+void shutdownJobSystem(JobSystem *jobs);
+void pushJob(JobSystem *jobs, JobProc proc, void *data, int32_t begin, int32_t end, JobCounter *counter);
+void parallelFor(JobSystem *jobs, JobProc proc, void *data, int32_t count, int32_t grain, JobCounter *counter);
+void waitForJobs(JobSystem *jobs, JobCounter *counter);
+//
+//===========================
+
+#endif
@@ -0,0 +1,171 @@
+#include "logger.h"
+#include <string.h>
+
+static const char *levelNames[LogLevelCount] = { "TRACE", "DEBUG", "INFO", "WARN", "ERROR" };
+static const char *categoryNames[LogCategoryCount] = { "general", "sim", "memory", "render", "replay", "raylib" };
+
+// Read by every thread that logs, written only while no other thread does.
+static Logger *activeLogger = NULL;
+
+// capacity is rounded up to a power of two. Opens path for writing; the
+// ring works without a file, it just never gets written out.
+bool initLogger(Logger *logger, MemoryArena *arena, int32_t capacity, const char *path, LogLevel minLevel)
+{
+	uint32_t slots = 1;
+	while (slots < (uint32_t)capacity)
+	{
+		slots <<= 1;
+	}
+
+	logger->entries = PushArray(arena, slots, LogEntry);
+	logger->mask = slots - 1;
+	for (uint32_t i = 0; i < slots; i++)
+	{
+		atomic_init(&logger->entries[i].sequence, i);
+	}
+	atomic_init(&logger->head, 0u);
+	logger->tail = 0;
+	atomic_init(&logger->dropped, 0u);
+	logger->minLevel = minLevel;
+	logger->startTime = platformGetSeconds();
+	atomic_init(&logger->quit, false);
+	logger->running = false;
+	logger->file = path ? fopen(path, "w") : NULL;
+	return logger->file != NULL;
+}
+
+// Drains everything published so far to the file. Only the flush thread
+// calls this while it runs. Returns how many messages were written.
+int32_t flushLogger(Logger *logger)
+{
+	int32_t written = 0;
+	for (;;)
+	{
+		LogEntry *entry = &logger->entries[logger->tail & logger->mask];
+		uint32_t sequence = atomic_load_explicit(&entry->sequence, memory_order_acquire);
+		if ((int32_t)(sequence - (logger->tail + 1)) < 0)
+		{
+			break;
+		}
+		if (logger->file)
+		{
+			fprintf(logger->file, "[%10.4f] %-5s %-7s %s\n", entry->time,
+				levelNames[entry->level], categoryNames[entry->category], entry->message);
+		}
+		atomic_store_explicit(&entry->sequence, logger->tail + logger->mask + 1, memory_order_release);
+		logger->tail++;
+		written++;
+	}
+
+	uint32_t dropped = atomic_exchange_explicit(&logger->dropped, 0u, memory_order_relaxed);
+	if (dropped && logger->file)
+	{
+		fprintf(logger->file, "[%10.4f] %-5s %-7s ring full, dropped %u messages\n",
+			platformGetSeconds() - logger->startTime, levelNames[LOG_LEVEL_WARNING],
+			categoryNames[LOG_CATEGORY_GENERAL], dropped);
+	}
+	if ((written || dropped) && logger->file)
+	{
+		fflush(logger->file);
+	}
+	return written;
+}
+
+static int loggerThreadProc(void *data)
+{
+	Logger *logger = (Logger *)data;
+	while (!atomic_load_explicit(&logger->quit, memory_order_acquire))
+	{
+		if (flushLogger(logger) == 0)
+		{
+			platformSleepSeconds(LOG_FLUSH_INTERVAL);
+		}
+	}
+	return 0;
+}
+
+bool startLogger(Logger *logger)
+{
+	atomic_store(&logger->quit, false);
+	logger->running = platformStartThread(&logger->thread, loggerThreadProc, logger);
+	return logger->running;
+}
+
+// Stops the flush thread, writes out whatever is left and closes the file.
+// Anything logged after this stays in the ring.
+void stopLogger(Logger *logger)
+{
+	if (logger->running)
+	{
+		atomic_store_explicit(&logger->quit, true, memory_order_release);
+		platformJoinThread(&logger->thread);
+		logger->running = false;
+	}
+	flushLogger(logger);
+	if (logger->file)
+	{
+		fclose(logger->file);
+		logger->file = NULL;
+	}
+}
+
+void setActiveLogger(Logger *logger)
+{
+	activeLogger = logger;
+}
+
+void logMessage(LogLevel level, LogCategory category, const char *format, ...)
+{
+	Logger *logger = activeLogger;
+	if (!logger || level < logger->minLevel)
+	{
+		return;
+	}
+	va_list args;
+	va_start(args, format);
+	logMessageV(level, category, format, args);
+	va_end(args);
+}
+
+void logMessageV(LogLevel level, LogCategory category, const char *format, va_list args)
+{
+	Logger *logger = activeLogger;
+	if (!logger || level < logger->minLevel)
+	{
+		return;
+	}
+
+	LogEntry *entry;
+	uint32_t position = atomic_load_explicit(&logger->head, memory_order_relaxed);
+	for (;;)
+	{
+		entry = &logger->entries[position & logger->mask];
+		uint32_t sequence = atomic_load_explicit(&entry->sequence, memory_order_acquire);
+		int32_t difference = (int32_t)(sequence - position);
+		if (difference == 0)
+		{
+			// on failure position is reloaded with the current head
+			if (atomic_compare_exchange_weak_explicit(&logger->head, &position, position + 1,
+				memory_order_relaxed, memory_order_relaxed))
+			{
+				break;
+			}
+		}
+		else if (difference < 0)
+		{
+			// the consumer has not freed this slot yet: ring full
+			atomic_fetch_add_explicit(&logger->dropped, 1u, memory_order_relaxed);
+			return;
+		}
+		else
+		{
+			position = atomic_load_explicit(&logger->head, memory_order_relaxed);
+		}
+	}
+
+	entry->level = (uint8_t)level;
+	entry->category = (uint8_t)category;
+	entry->time = platformGetSeconds() - logger->startTime;
+	vsnprintf(entry->message, sizeof(entry->message), format, args);
+	atomic_store_explicit(&entry->sequence, position + 1, memory_order_release);
+}
@@ -0,0 +1,89 @@
+#ifndef LOGGER_H
+#define LOGGER_H
+
+#include "arena.h"
+#include "platform.h"
+#include <stdarg.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+// In-memory diagnostics log. Any thread appends to a bounded lock-free ring
+// (a sequence number per slot, producers claim slots with one CAS) and a
+// background thread drains it to a file, so a log call never takes a lock or
+// makes a syscall. Calls below the minimum level return after one compare.
+// When the ring is full new messages are counted and dropped rather than
+// waited on.
+//
+// Code logs through the active logger set with setActiveLogger; with none
+// set every call is a no-op.
+
+// levels and categories are prefixed to stay clear of raylib's LOG_* names
+typedef enum
+{
+	LOG_LEVEL_TRACE,
+	LOG_LEVEL_DEBUG,
+	LOG_LEVEL_INFO,
+	LOG_LEVEL_WARNING,
+	LOG_LEVEL_ERROR,
+	LogLevelCount
+} LogLevel;
+
+typedef enum
+{
+	LOG_CATEGORY_GENERAL,
+	LOG_CATEGORY_SIM,
+	LOG_CATEGORY_MEMORY,
+	LOG_CATEGORY_RENDER,
+	LOG_CATEGORY_REPLAY,
+	LOG_CATEGORY_RAYLIB,
+	LogCategoryCount
+} LogCategory;
+
+#define LOG_MESSAGE_SIZE 112
+#define LOG_DEFAULT_CAPACITY 4096
+// how long the flush thread sleeps when the ring is empty
+#define LOG_FLUSH_INTERVAL 0.01
+
+typedef struct LogEntry
+{
+	// slot i is free for the producer at position p when sequence == p, and
+	// holds a message for the consumer when sequence == p + 1
+	_Atomic uint32_t sequence;
+	uint8_t level;
+	uint8_t category;
+	double time;
+	char message[LOG_MESSAGE_SIZE];
+} LogEntry;
+
+typedef struct Logger
+{
+	LogEntry *entries;
+	uint32_t mask;
+	// producers and the consumer on separate lines
+	_Alignas(64) _Atomic uint32_t head;
+	_Alignas(64) uint32_t tail;
+	_Atomic uint32_t dropped;
+
+	LogLevel minLevel;
+	double startTime;
+	FILE *file;
+	PlatformThread thread;
+	atomic_bool quit;
+	bool running;
+} Logger;
+
+//functions==================
+//
+bool initLogger(Logger *logger, MemoryArena *arena, int32_t capacity, const char *path, LogLevel minLevel);
+bool startLogger(Logger *logger);
+void stopLogger(Logger *logger);
+void setActiveLogger(Logger *logger);
+void logMessage(LogLevel level, LogCategory category, const char *format, ...);
+void logMessageV(LogLevel level, LogCategory category, const char *format, va_list args);
+int32_t flushLogger(Logger *logger);
+//
+//===========================
+
+#endif
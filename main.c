@@ -1,128 +1,107 @@
 #include "raylib.h"
+#include "rlgl.h"
+#include "sim.h"
+#include "render.h"
+#include "render_commands.h"
+#include "sim_thread.h"
+#include "game_code.h"
+#include "logger.h"
+#include "profiler.h"
 #include <math.h>
+#include <stdarg.h>
 #include <stdatomic.h>
 #include <stdbool.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
-#include <vcruntime.h>
-
-#define SCREENWIGTH 640
-#define SCREENHEIGTH 320
-
-#define PLAYER_BASE_LEN 20
-#define PlAYER_SPEED 200.0
-#define PLAYER_OFFSET_BOTTOM 20.0
-#define PLAYER_SHAPE_POINTS 8
-#define PLAYER_BULLETS 50
-#define ENEMEY_NUMBER 5
-
-#define Kilobytes(Value) ((Value) * 1024LL)
-#define Megabytes(Value) (Kilobytes(Value) * 1024LL)
-#ifndef M_PI
-#    define M_PI 3.14159265358979323846
-#endif
-
-typedef struct GameMemory 
-{
-	size_t PermanantStorageSize;
-	void *PermanantStorage;
-
-	size_t TransientStorageSize;
-	void *TransientStorage;
-
-	bool IsInitialised;
-} GameMemory;
-
-typedef struct Player
-{
-	Vector2 position;
-	float speed;
-	Rectangle collider;
-	Vector2 playerShape[PLAYER_SHAPE_POINTS];
-	float scale;
-} Player;
-
-typedef struct Bullet
-{
-	Vector2 position;
-	Vector2 startPos;
-	Vector2 velocity;
-	Rectangle collider;
-	bool active;
-} Bullet;
-
-typedef struct Enemy
-{
-	Vector2 position;
-	float scale;
-	bool active;
-	Rectangle collider;
-	int num_shape_points;
-	Vector2 shape_points[14];
-} Enemy;
-
-typedef struct EnemeyWave
-{
-	int32_t enemy_number;
-	Vector2 wave_position;
-	Enemy *enemies;
-	int32_t enemyType;
-	bool is_moving;
-	float move_timer;
-} EnemyWave;
-
-typedef enum 
-{
-	GAME,
-	MAIN,
-	PAUSE
-} StateType;
-
-typedef enum
-{
-	Alien,
-	Boss
-} EnemyType ;
-
-typedef struct State 
-{
-	StateType state;
-	Player *player;
-	Bullet *playerBullets;
-	Bullet *display_playerBullets;
-	int bulletCount;
-	EnemyWave *enemyWave;
-} State;
+#include <string.h>
+#include <time.h>
+
+// Render-thread scratch, separate from the sim's frame arena since the two
+// threads run concurrently.
+#define RENDER_ARENA_SIZE Megabytes(8)
+
+// every session is recorded here unless --record says otherwise
+#define DEFAULT_REPLAY_PATH "session.replay"
+#define DEFAULT_LOG_PATH "session.log"
+#define DEFAULT_STATE_PATH "session.state"
+// rewind history: one push every SIM_HISTORY_INTERVAL ticks, a minute's worth
+#define HISTORY_CAPACITY (60 * SIM_HZ / SIM_HISTORY_INTERVAL)
+
+// how often the profile overlay re-reads its percentiles and the CSV gets a row
+#define PROFILE_OVERLAY_REFRESH 0.25
+#define PROFILE_EXPORT_INTERVAL 1.0
+// one 60 Hz frame
+#define FRAME_BUDGET_MS 16.6f
 
 //functions==================
 //
-void input(State *state);
-void init(GameMemory *game, State *state, Player *player);
-void update(State *state);
-void drawPlayer(State *state);
-void shootBullet(State *state);
-void updateBullets(State *state);
-void drawBullets(State *state);
-void clearBullets(State *state);
-Enemy* initSingularEnemey(void *gamememory, int32_t type, int index);
-void drawEnemies(State *state);
-void enemyWaveRandomMovement(EnemyWave *wave);
-
-float random_float(float min, float max);
-bool checkCollision(Rectangle a, Rectangle b);
-float easeInOut(float t);
+InputFrame sampleInput(void);
+State *init(GameMemory *game, const SimConfig *config, const char *logPath);
+void raylibTraceLog(int logLevel, const char *text, va_list args);
+void update(SimThread *sim);
+void executeRenderCommands(const RenderCommandBuffer *buffer, float alpha, MemoryArena *scratch);
+void absorbSimTimings(const FrameSnapshot *snapshot);
+void drawProfileOverlay(void);
 //
 //===========================
 
 
-static float shipHeight = 0.0f;
 static GameMemory gameMemory = {0};
-int main(void)
+static EnemyRenderer enemyRenderer = {0};
+static MemoryArena renderArena = {0};
+static SimThread simThread = {0};
+static JobSystem jobSystem = {0};
+static ReplayWriter recorder = {0};
+static GameCode gameCode = {0};
+static SnapshotRing history = {0};
+static Logger logger = {0};
+static Profiler frameProfiler = {0};
+static ProfileStats overlayStats[ProfilePhaseCount] = {0};
+static FILE *profileCsv = NULL;
+static bool showColliders = true;
+static bool showProfiler = false;
+int main(int argc, char **argv)
 {
-	gameMemory.PermanantStorageSize = Megabytes(64);
-	gameMemory.TransientStorageSize = Megabytes(128);
-	gameMemory.PermanantStorage = malloc(gameMemory.PermanantStorageSize);
+	const char *replayPath = DEFAULT_REPLAY_PATH;
+	const char *logPath = DEFAULT_LOG_PATH;
+	const char *profilePath = NULL;
+	const char *gamePath = NULL;
+	const char *statePath = DEFAULT_STATE_PATH;
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "--record") == 0 && i + 1 < argc)
+		{
+			replayPath = argv[++i];
+		}
+		else if (strcmp(argv[i], "--log") == 0 && i + 1 < argc)
+		{
+			logPath = argv[++i];
+		}
+		else if (strcmp(argv[i], "--profile") == 0 && i + 1 < argc)
+		{
+			profilePath = argv[++i];
+		}
+		else if (strcmp(argv[i], "--game") == 0 && i + 1 < argc)
+		{
+			gamePath = argv[++i];
+		}
+		else if (strcmp(argv[i], "--state") == 0 && i + 1 < argc)
+		{
+			statePath = argv[++i];
+		}
+		else
+		{
+			fprintf(stderr, "usage: %s [--record REPLAY] [--log FILE] [--profile CSV] [--game MODULE (hot reloaded)]\n"
+				"       [--state FILE (F5 saves, F9 loads)]\n", argv[0]);
+			return 1;
+		}
+	}
+
+	gameMemory.PermanantStorageSize = PERMANENT_STORAGE_SIZE;
+	gameMemory.TransientStorageSize = TRANSIENT_STORAGE_SIZE;
+	// zeroed, so alignment padding in the state is the same in every run
+	gameMemory.PermanantStorage = calloc(1, gameMemory.PermanantStorageSize);
 	gameMemory.TransientStorage = malloc(gameMemory.TransientStorageSize);
 	gameMemory.IsInitialised = false;
 
@@ -131,395 +110,311 @@ int main(void)
 		return -1; // Failed to allocate memory
 	}
 
-	Player *player = (Player *)gameMemory.PermanantStorage;
-	State *state = (State *)((uint8_t *)gameMemory.PermanantStorage + sizeof(Player));
-
-	init(&gameMemory, state, player);
-
-	update(state);
-	
-	CloseWindow();
-
-	free(gameMemory.PermanantStorage);
-	free(gameMemory.TransientStorage);
-
-	return 0;
-}
-
-void init(GameMemory *game, State *state, Player *player)
-{
-	if (!game->IsInitialised)
+	SimConfig config = defaultSimConfig();
+	config.seed = (uint32_t)time(NULL);
+	State *state = init(&gameMemory, &config, logPath);
+	if (!state)
 	{
-		InitWindow(SCREENWIGTH, SCREENHEIGTH, "space invaders");
-
-		shipHeight = (PLAYER_BASE_LEN/2.0) / tanf(20*DEG2RAD);
-		player->position = (Vector2){SCREENWIGTH/2.0, SCREENHEIGTH - shipHeight};
-		player->speed = PlAYER_SPEED;
-		player->collider = (Rectangle){
-			player->position.x - (PLAYER_BASE_LEN/2.0), 
-			player->position.y - shipHeight,
-			PLAYER_BASE_LEN,
-			shipHeight
-		};
-		player->scale = 25.0f;
-		Vector2 playershapeinit[PLAYER_SHAPE_POINTS] = {
-			(Vector2){0.0f, 0.0f},
-			(Vector2){0.0f, -1.0f},
-			(Vector2){-0.5f, 0.0f},
-			(Vector2){-0.25f, 0.25f},
-			(Vector2){0.0f, 0.0f},
-			(Vector2){0.25f, 0.25f},
-			(Vector2){0.5f, 0.0f},
-			(Vector2){0.0f, -1.0f},
-		};
-
-		for (int i = 0; i < PLAYER_SHAPE_POINTS; i++) {
-			player->playerShape[i] = playershapeinit[i];
-		}
-		
-		//state-data
-		state->player = player;
-		state->state = GAME;
-		state->playerBullets = (Bullet *)((uint8_t *)gameMemory.PermanantStorage + sizeof(Player) + sizeof(State));
-		state->display_playerBullets = (Bullet *)((uint8_t *)gameMemory.PermanantStorage + sizeof(Player) + sizeof(State) + (sizeof(Bullet) * PLAYER_BULLETS));
-		state->bulletCount = 0;
-
-		for (int i = 0; i < PLAYER_BULLETS; i++) {
-		    state->playerBullets[i].active = false;
-		    state->display_playerBullets[i].active = false;
-		}
-
-		state->enemyWave = (EnemyWave *)game->TransientStorage;
-		state->enemyWave->enemyType = Alien;
-		state->enemyWave->is_moving = false;
-		if(state->enemyWave->enemyType == Alien)
+		fprintf(stderr, "game memory too small for the game state\n");
+		return -1;
+	}
+	if (profilePath)
+	{
+		profileCsv = fopen(profilePath, "w");
+		if (profileCsv)
 		{
-			state->enemyWave->enemy_number= ENEMEY_NUMBER;
+			writeProfileCsvHeader(profileCsv);
 		}
-		state->enemyWave->wave_position = (Vector2){100.0f, 50.0f};
-		state->enemyWave->enemies = (Enemy *)((uint8_t *)gameMemory.TransientStorage + sizeof(EnemyWave));
-
-		for(int i = 0; i < state->enemyWave->enemy_number; i++)
+		else
 		{
-			Enemy *enemy = initSingularEnemey((uint8_t *)game->TransientStorage + sizeof(EnemyWave) + i * sizeof(Enemy), Alien, i);
-			enemy->position = (Vector2){state->enemyWave->wave_position.x + i * 50.0f, state->enemyWave->wave_position.y};
-			enemy->active = true;
-			state->enemyWave->enemies[i] = *enemy;
-
+			logMessage(LOG_LEVEL_WARNING, LOG_CATEGORY_GENERAL, "could not open %s, no profile export", profilePath);
 		}
-
-		game->IsInitialised = true;
 	}
-}
 
-void update(State *state)
-{
-	while (!WindowShouldClose())
+	if (!initSimThread(&simThread, &gameMemory, state, showColliders))
 	{
-		input(state);
-		updateBullets(state);
-		clearBullets(state);
-
-		BeginDrawing();
-			ClearBackground(RAYWHITE);
-			drawPlayer(state);
-			drawBullets(state);
-			drawEnemies(state);
-			enemyWaveRandomMovement(state->enemyWave);
-		EndDrawing();
+		logMessage(LOG_LEVEL_ERROR, LOG_CATEGORY_MEMORY, "no room for the snapshot buffers");
+		return -1;
 	}
-
-}
-
-void drawPlayer(State *state) 
-{
-	Vector2 scaledShape[PLAYER_SHAPE_POINTS];
-	for (int i = 0; i < PLAYER_SHAPE_POINTS; i++)
+	if (gamePath)
 	{
-		scaledShape[i].x = (state->player->position.x) + (state->player->playerShape[i].x * state->player->scale);
-		scaledShape[i].y = (state->player->position.y) + (state->player->playerShape[i].y * state->player->scale);
+		initGameCode(&gameCode, gamePath);
+		simThread.code = &gameCode;
 	}
-
-	//colider debugger
-	DrawRectangleLinesEx(state->player->collider, 2.0f,RED);
-
-	DrawTriangleFan(scaledShape, PLAYER_SHAPE_POINTS, BLUE);
-}
-
-void input(State *state)
-{
-	if ((IsKeyDown(KEY_RIGHT)|| IsKeyDown(KEY_D)) 
-		&& state->player->position.x <= SCREENWIGTH - PLAYER_BASE_LEN) 
+	simThread.statePath = statePath;
+	if (initSnapshotRing(&history, &transientState(&gameMemory)->transientArena, &gameMemory, HISTORY_CAPACITY))
 	{
-		state->player->position.x += state->player->speed * GetFrameTime();
+		simThread.history = &history;
 	}
-	if ((IsKeyDown(KEY_LEFT) || IsKeyDown(KEY_A)) 
-		&& state->player->position.x >= 0 + PLAYER_BASE_LEN)
+	else
 	{
-		state->player->position.x -= state->player->speed * GetFrameTime();
+		logMessage(LOG_LEVEL_WARNING, LOG_CATEGORY_MEMORY, "no room for the rewind history");
 	}
-	if ((IsKeyDown(KEY_UP) || IsKeyDown(KEY_W)) 
-		&& state->player->position.y >= 0 + shipHeight)
+	if (openReplayWriter(&recorder, replayPath, &config, SIM_HZ))
 	{
-		state->player->position.y -= state->player->speed * GetFrameTime();
+		simThread.recorder = &recorder;
 	}
-	if ((IsKeyDown(KEY_DOWN) || IsKeyDown(KEY_S)) 
-		&& state->player->position.y <= SCREENHEIGTH - shipHeight)
+	else
 	{
-		state->player->position.y += state->player->speed * GetFrameTime();
+		logMessage(LOG_LEVEL_WARNING, LOG_CATEGORY_REPLAY, "could not open %s, session will not be recorded", replayPath);
 	}
-	if (IsKeyPressed(KEY_SPACE)) 
+	if (!startSimThread(&simThread))
 	{
-		//initialise bullets
-		shootBullet(state);
+		return -1;
 	}
-
-	// Update collider position
-	state->player->collider.x = state->player->position.x - (PLAYER_BASE_LEN/2.0);
-	state->player->collider.y = state->player->position.y - shipHeight;
-}
-
-void shootBullet(State *state)
-{
-	for(int i = 0; i < PLAYER_BULLETS; i++)	
+	update(&simThread);
+	stopSimThread(&simThread);
+	unloadGameCode(&gameCode);
+	shutdownJobSystem(&jobSystem);
+	closeReplayWriter(&recorder, hashState(state));
+	if (profileCsv)
 	{
-		if(!state->playerBullets[i].active)
-		{
-			state->playerBullets[i].position = (Vector2){ state->player->position.x, state->player->position.y - shipHeight };
-			state->playerBullets[i].velocity = (Vector2){ 0, -500 }; // Bullets move up
-			state->playerBullets[i].collider = (Rectangle){ state->playerBullets[i].position.x - 2.5f, state->playerBullets[i].position.y, 5, 10 };
-			state->playerBullets[i].active = true;
-			state->bulletCount++;
-			break;
-		}
-
+		fclose(profileCsv);
 	}
-}
 
-void updateBullets(State *state)
-{
-    for (int i = 0; i < PLAYER_BULLETS; i++) {
-        if (state->playerBullets[i].active) {
-            state->playerBullets[i].position.y += state->playerBullets[i].velocity.y * GetFrameTime();
+	unloadEnemyRenderer(&enemyRenderer);
+	CloseWindow();
+	setActiveLogger(NULL);
+	gameMemory.logger = NULL;
+	stopLogger(&logger);
 
-            // Update collider position
-            state->playerBullets[i].collider.x = state->playerBullets[i].position.x - 2.5f;
-            state->playerBullets[i].collider.y = state->playerBullets[i].position.y;
+	reportMemory(&gameMemory);
 
-            // Check if bullet is out of screen
-            if (state->playerBullets[i].position.y < 0) {
-                state->playerBullets[i].active = false;
-                state->bulletCount--;
-            } else {
-                // Add to display_playerBullets
-                state->display_playerBullets[i] = state->playerBullets[i];
-            }
-        }
-    }
-}
-
-void clearBullets(State *state)
-{
-    for (int i = 0; i < PLAYER_BULLETS; i++) {
-        if (!state->playerBullets[i].active) {
-            state->display_playerBullets[i].active = false;
-        }
-    }
-}
+	free(gameMemory.PermanantStorage);
+	free(gameMemory.TransientStorage);
 
-void drawBullets(State *state)
-{
-    for (int i = 0; i < PLAYER_BULLETS; i++) {
-        if (state->display_playerBullets[i].active) {
-            DrawRectangleRec(state->display_playerBullets[i].collider, RED);
-        }
-    }
+	return 0;
 }
 
-Enemy* initSingularEnemey(void *gamememory, int32_t type, int index)
+// The logger comes up before the window so raylib's own start-up messages
+// go through it too.
+State *init(GameMemory *game, const SimConfig *config, const char *logPath)
 {
-	
-	Vector2 alien_shape_points[] = {
-			(Vector2){0.0f, 0.0f},
-			(Vector2){0.0f, -1.0f},
-			(Vector2){-0.5f, -0.5f},
-			(Vector2){-1.0f, 0.0f},
-			(Vector2){-0.5f, 0.25f},
-			(Vector2){0.0f, 0.25f},
-			(Vector2){-0.25f, 0.25f},
-			(Vector2){0.0f, 1.0f},
-			(Vector2){0.25f, 0.25f},
-			(Vector2){0.0f, 0.25f},
-			(Vector2){0.5f, 0.25f},
-			(Vector2){1.0f, 0.0f},
-			(Vector2){0.5f, -0.5f},
-			(Vector2){0.0f, -1.0f},
-		};
-
-	Vector2 boss_shape_points[] = {
-		(Vector2){0.0f, 0.0f},
-		(Vector2){1.0f, 0.0f},
-		(Vector2){1.0f, 1.0f},
-		(Vector2){0.0f, 1.0f},
-		(Vector2){-1.0f, 1.0f},
-		(Vector2){-1.0f, 0.0f},
-		(Vector2){0.0f, -1.0f},
-		(Vector2){1.0f, -1.0f},
-	    };
-
-	int num_points;
-	Vector2 *shape_points;
-
-	if (type == Alien)
-	{
-		num_points = sizeof(alien_shape_points) / sizeof(Vector2);
-		shape_points = alien_shape_points;
-	}
-	else if (type == Boss)
+	bool firstInit = !game->IsInitialised;
+	State *state = initState(game, config);
+	if (!state)
 	{
-		num_points = sizeof(boss_shape_points) / sizeof(Vector2);
-		shape_points = boss_shape_points;
+		return NULL;
 	}
-	else
+	MemoryArena *transientArena = &transientState(game)->transientArena;
+	if (!initLogger(&logger, transientArena, LOG_DEFAULT_CAPACITY, logPath, LOG_LEVEL_INFO))
 	{
-		return NULL; // Invalid enemy type
+		fprintf(stderr, "could not open %s, logging to memory only\n", logPath);
 	}
-	
-	 // Calculate the memory needed for the Enemy struct plus the shape points
-    size_t memory_needed = sizeof(Enemy) + num_points * sizeof(Vector2);
+	startLogger(&logger);
+	setActiveLogger(&logger);
+	game->logger = &logger;
+	SetTraceLogCallback(raylibTraceLog);
 
-    // Allocate the required memory
-    Enemy* enemy = (Enemy*)((uint8_t*)gamememory + index * memory_needed);
-
-	// Ensure each enemy has its own space in memory
-	//Enemy* enemy = (Enemy*)((uint8_t*)gamememory + index * sizeof(Enemy));
-	enemy->scale = (type == Alien) ? 22.0f : 50.0f;
-	enemy->active = false;
-	enemy->position = (Vector2){0.0f, 0.0f};
-	enemy->collider = (Rectangle){0, 0, 50, 50};
-	enemy->num_shape_points = num_points;
-
-	for (int i = 0; i < num_points; i++)
+	if (firstInit)
 	{
-		enemy->shape_points[i] = alien_shape_points[i];
+		InitWindow(SCREENWIGTH, SCREENHEIGTH, "space invaders");
 	}
-
-	return enemy;
+	subArena(&renderArena, transientArena, "render", RENDER_ARENA_SIZE);
+	// one core stays with the render thread, the rest tick the sim
+	initJobSystem(&jobSystem, transientArena, platformCpuCount() - 1);
+	game->jobs = &jobSystem;
+	initEnemyRenderer(&enemyRenderer, &renderArena, ENEMY_INSTANCE_CAPACITY);
+	return state;
 }
 
-void drawEnemies(State *state)
+// Render thread. The simulation ticks on its own thread; this loop only
+// forwards input and draws the newest published snapshot, interpolated
+// between that snapshot's previous and current tick by how far wall time has
+// moved past it.
+void update(SimThread *sim)
 {
-    for (int i = 0; i < state->enemyWave->enemy_number; i++)
-    {
-        if (state->enemyWave->enemies[i].active)
-        {
-            Enemy *enemy = &state->enemyWave->enemies[i];
-            int num_points = enemy->num_shape_points;
-            Vector2 scaledShape[num_points];
-            for (int j = 0; j < num_points; j++)
-            {
-                scaledShape[j].x = (enemy->position.x) + (enemy->shape_points[j].x * enemy->scale);
-                scaledShape[j].y = (enemy->position.y) + (enemy->shape_points[j].y * enemy->scale);
-            }
+	initProfiler(&frameProfiler);
+	double lastOverlayRefresh = 0.0;
+	double lastExport = platformGetSeconds();
 
-            // Collider debugger
-            // Adjust the collider position to the enemy's world position
-            Rectangle adjustedCollider = {
-		enemy->position.x - (enemy->collider.width) / 2,
-                enemy->position.y - (enemy->collider.height) / 2,
-                enemy->collider.width,
-                enemy->collider.height
-            };
+	while (!WindowShouldClose())
+	{
+		beginProfilePhase(&frameProfiler, PROFILE_FRAME);
+		arenaReset(&renderArena);
 
-	    enemy->collider = adjustedCollider;
+		beginProfilePhase(&frameProfiler, PROFILE_FRAME_INPUT);
+		InputFrame input = sampleInput();
+		if (IsKeyPressed(KEY_F1))
+		{
+			showColliders = !showColliders;
+			atomic_store(&sim->showColliders, showColliders);
+		}
+		if (IsKeyPressed(KEY_F2))
+		{
+			showProfiler = !showProfiler;
+		}
+		if (IsKeyPressed(KEY_F5))
+		{
+			requestSimSaveState(sim);
+		}
+		if (IsKeyPressed(KEY_F9))
+		{
+			requestSimLoadState(sim);
+		}
+		if (IsKeyDown(KEY_BACKSPACE))
+		{
+			requestSimRewind(sim, 1);
+		}
+		InputFrame held = { (uint8_t)(input.buttons & ~INPUT_SHOOT) };
+		InputFrame pressed = { (uint8_t)(input.buttons & INPUT_SHOOT) };
+		submitSimInput(sim, &held, &pressed);
+		endProfilePhase(&frameProfiler, PROFILE_FRAME_INPUT);
+
+		bool fresh;
+		const FrameSnapshot *snapshot = acquireFrameSnapshot(sim, &fresh);
+		if (fresh)
+		{
+			absorbSimTimings(snapshot);
+		}
+		float alpha = (float)((platformGetSeconds() - snapshot->publishTime) / SIM_DT);
+		alpha = (alpha < 0.0f) ? 0.0f : (alpha > 1.0f) ? 1.0f : alpha;
 
-	    DrawRectangleLinesEx(adjustedCollider, 2.0f, RED);
-		
+		BeginDrawing();
+			beginProfilePhase(&frameProfiler, PROFILE_FRAME_DRAW);
+			ClearBackground(RAYWHITE);
+			executeRenderCommands(&snapshot->commands, alpha, &renderArena);
+			if (showProfiler)
+			{
+				drawProfileOverlay();
+			}
+			endProfilePhase(&frameProfiler, PROFILE_FRAME_DRAW);
+		beginProfilePhase(&frameProfiler, PROFILE_FRAME_SWAP);
+		EndDrawing();
+		endProfilePhase(&frameProfiler, PROFILE_FRAME_SWAP);
+		endProfilePhase(&frameProfiler, PROFILE_FRAME);
+
+		double now = platformGetSeconds();
+		if (showProfiler && now - lastOverlayRefresh >= PROFILE_OVERLAY_REFRESH)
+		{
+			for (int phase = 0; phase < ProfilePhaseCount; phase++)
+			{
+				overlayStats[phase] = profilePhaseStats(&frameProfiler, (ProfilePhase)phase);
+			}
+			lastOverlayRefresh = now;
+		}
+		if (profileCsv && now - lastExport >= PROFILE_EXPORT_INTERVAL)
+		{
+			writeProfileCsvRow(profileCsv, &frameProfiler, now - logger.startTime);
+			lastExport = now;
+		}
+	}
 
-            DrawTriangleFan(scaledShape, num_points, GREEN);
-        }
-    }
 }
 
-float random_float(float min, float max)
+// Feeds the sim thread's per-tick timings carried by a new snapshot into the
+// render thread's profiler, so one profiler covers both threads.
+void absorbSimTimings(const FrameSnapshot *snapshot)
 {
-	return ((float)rand() / RAND_MAX) * (max - min) + min;
+	for (int32_t tick = 0; tick < snapshot->tickTimingCount; tick++)
+	{
+		for (int phase = 0; phase < PROFILE_SIM_RECORD; phase++)
+		{
+			addProfileSample(&frameProfiler, (ProfilePhase)phase, snapshot->tickTimings[tick][phase]);
+		}
+	}
+	for (int32_t i = 0; i < snapshot->recordTimingCount; i++)
+	{
+		addProfileSample(&frameProfiler, PROFILE_SIM_RECORD, snapshot->recordTimings[i]);
+	}
 }
 
-bool checkCollision(Rectangle a, Rectangle b) 
+// F2. Per-phase last / p50 / p99 in ms, refreshed a few times a second;
+// a p99 over one 60 Hz frame is drawn in red.
+void drawProfileOverlay(void)
 {
-    return (a.x < b.x + b.width &&
-            a.x + a.width > b.x &&
-            a.y < b.y + b.height &&
-            a.y + a.height > b.y);
+	const int lineHeight = 12;
+	const int x = 8;
+	int y = 8;
+	DrawRectangle(x - 4, y - 4, 250, lineHeight * (ProfilePhaseCount + 1) + 8, Fade(BLACK, 0.7f));
+	DrawText(TextFormat("%-14s %7s %7s %7s", "phase (ms)", "last", "p50", "p99"), x, y, 10, RAYWHITE);
+	for (int phase = 0; phase < ProfilePhaseCount; phase++)
+	{
+		y += lineHeight;
+		const ProfileStats *stats = &overlayStats[phase];
+		Color color = (stats->p99 > FRAME_BUDGET_MS) ? RED : RAYWHITE;
+		DrawText(TextFormat("%-14s %7.3f %7.3f %7.3f", profilePhaseName((ProfilePhase)phase),
+			stats->last, stats->p50, stats->p99), x, y, 10, color);
+	}
 }
 
+void raylibTraceLog(int logLevel, const char *text, va_list args)
+{
+	LogLevel level = LOG_LEVEL_ERROR;
+	switch (logLevel)
+	{
+		case LOG_TRACE: level = LOG_LEVEL_TRACE; break;
+		case LOG_DEBUG: level = LOG_LEVEL_DEBUG; break;
+		case LOG_INFO: level = LOG_LEVEL_INFO; break;
+		case LOG_WARNING: level = LOG_LEVEL_WARNING; break;
+		default: break;
+	}
+	logMessageV(level, LOG_CATEGORY_RAYLIB, text, args);
+}
 
-float easeInOut(float t)
+InputFrame sampleInput(void)
 {
-	return -(cos(M_PI * t) - 1) / 2;
+	InputFrame input = {0};
+	if (IsKeyDown(KEY_RIGHT) || IsKeyDown(KEY_D)) input.buttons |= INPUT_RIGHT;
+	if (IsKeyDown(KEY_LEFT) || IsKeyDown(KEY_A)) input.buttons |= INPUT_LEFT;
+	if (IsKeyDown(KEY_UP) || IsKeyDown(KEY_W)) input.buttons |= INPUT_UP;
+	if (IsKeyDown(KEY_DOWN) || IsKeyDown(KEY_S)) input.buttons |= INPUT_DOWN;
+	if (IsKeyPressed(KEY_SPACE)) input.buttons |= INPUT_SHOOT;
+	return input;
 }
 
-void enemyWaveRandomMovement(EnemyWave *wave)
+// The only place game visuals reach raylib. Draws every command alpha of the
+// way from its previous to its current position. Expects a sorted buffer: runs
+// of the same enemy outline and colour become one instanced draw, everything
+// else goes through the immediate-mode batch. Without GL 3.3 outlines are
+// drawn one by one under a translation.
+void executeRenderCommands(const RenderCommandBuffer *buffer, float alpha, MemoryArena *scratch)
 {
-	static Vector2 start_position = {0.0f, 0.0f};
-	static Vector2 target_position = {0.0f, 0.0f};
-	static float elapsed_time = 0.0f;
-	static bool target_set = false;
+	ArenaMark mark = arenaMark(scratch);
+	Vector2 *offsets = PushArray(scratch, buffer->count, Vector2);
 
-	if (!wave->is_moving) 
+	for (int32_t i = 0; i < buffer->count; i++)
 	{
-		wave->move_timer += GetFrameTime(); // Update the timer
-
-		// Check if 5 seconds have passed
-		if (wave->move_timer >= 5.0f) 
+		const RenderCommand *command = &buffer->commands[i];
+		Vector2 position = interpolatedPosition(command, alpha);
+		Rectangle rect = { position.x, position.y, command->size.x, command->size.y };
+		switch (command->type)
 		{
-		    wave->is_moving = true;
-		    wave->move_timer = 0.0f; // Reset the timer
-		    start_position = wave->wave_position;
-
-			target_position.x = random_float(-100.0, 100.0);
-			elapsed_time = 0.0f;
-			target_set = true;
+			case RENDER_RECT:
+			{
+				DrawRectangleRec(rect, command->color);
+			} break;
+			case RENDER_RECT_LINES:
+			{
+				DrawRectangleLinesEx(rect, 2.0f, command->color);
+			} break;
+			case RENDER_OUTLINE:
+			{
+				if (command->shape < EnemyTypeCount && enemyRenderer.ready)
+				{
+					int count = 0;
+					int32_t run = i;
+					while (run < buffer->count
+						&& buffer->commands[run].type == RENDER_OUTLINE
+						&& buffer->commands[run].shape == command->shape
+						&& ColorToInt(buffer->commands[run].color) == ColorToInt(command->color))
+					{
+						offsets[count++] = interpolatedPosition(&buffer->commands[run++], alpha);
+					}
+					drawEnemyInstances(&enemyRenderer, command->shape, offsets, count, command->color);
+					i = run - 1;
+				}
+				else
+				{
+					const Shape *shape = (command->shape == SHAPE_PLAYER) ? &playerShape : &enemyShapes[command->shape];
+					rlPushMatrix();
+						rlTranslatef(position.x, position.y, 0.0f);
+						DrawTriangleFan(shape->points, shape->pointCount, command->color);
+					rlPopMatrix();
+				}
+			} break;
 		}
 	}
 
-	if (wave->is_moving && target_set)
-	{
-		 elapsed_time += GetFrameTime();
-        float t = elapsed_time / 1.0f; // Duration of 1 second for the ease-in-out movement
-        if (t >= 1.0f) 
-        {
-            t = 1.0f;
-            wave->is_moving = false; // Stop moving after reaching the target
-            target_set = false; // Reset the target flag
-        }
-	// Apply ease-in-out to the interpolation
-        float ease = easeInOut(t);
-        Vector2 new_wave_position = {
-            start_position.x + (target_position.x - start_position.x) * ease,
-            start_position.y + (target_position.y - start_position.y) * ease
-        };
-	printf("vector x: %f, y:%f\n", wave->wave_position.x, wave->wave_position.y);
-	//wave->wave_position.y = random_float(20.0, 50.0);
-	
-	 for (int i = 0; i < wave->enemy_number; i++) 
-        {
-            if (wave->enemies[i].active) 
-            {
-                float new_x = wave->enemies[i].position.x + (new_wave_position.x - wave->wave_position.x);
-                float new_x_col = wave->enemies[i].collider.x + (new_wave_position.x - wave->wave_position.x);
-
-                // Check if the new X position is within screen bounds
-                if (new_x >= 0 && new_x_col + wave->enemies[i].collider.width <= SCREENWIGTH) 
-                {
-                    wave->enemies[i].position.x = new_x;
-                    wave->enemies[i].collider.x = new_x_col;
-                }
-            }
-        }
-
-        wave->wave_position = new_wave_position;
-	
-	}
+	arenaRewind(mark);
 }
@@ -0,0 +1,142 @@
+#!/bin/bash
+
+# Optimised release pipeline for Linux:
+#   1. Release + LTO build without a profile, the baseline
+#   2. instrumented PGO build (-fprofile-generate, LTO)
+#   3. run the replay corpus through it to collect a profile
+#   4. PGO + LTO rebuild from that profile, plus a -march variant if asked
+#   5. run the corpus on every build and report us/tick against the baseline
+#
+# The PGO build type is Release plus the profile flags, so the pgo delta is
+# the profile's alone; the pgo-march one also includes -march.
+#
+# Every replay checks its final state hash, so a build that changes the
+# simulation's behaviour fails here instead of just looking fast.
+#
+# usage: ./pgo.sh [--corpus DIR] [--march ARCH] [--runs N] [--workers N]
+#
+# Without --corpus a small corpus of scripted runs is recorded into the
+# build directory; replays recorded from the game with --record can be
+# dropped in a directory and passed instead.
+
+set -e
+
+ROOT="$(cd "$(dirname "$0")" && pwd)"
+BUILD_DIR="$ROOT/build/pgo"
+CORPUS_DIR=""
+MARCH=""
+RUNS=3
+WORKERS=1
+
+while [ $# -gt 0 ]; do
+    case "$1" in
+        --corpus) CORPUS_DIR="$2"; shift 2 ;;
+        --march) MARCH="$2"; shift 2 ;;
+        --runs) RUNS="$2"; shift 2 ;;
+        --workers) WORKERS="$2"; shift 2 ;;
+        *) echo "usage: $0 [--corpus DIR] [--march ARCH] [--runs N] [--workers N]"; exit 1 ;;
+    esac
+done
+
+JOBS="$(nproc 2>/dev/null || echo 4)"
+
+# build <tree> <binary name> <cmake args...>; the headless binary is copied
+# to bin/<binary name> so one tree can produce several variants
+build() {
+    local dir="$BUILD_DIR/$1"
+    local name="$2"
+    shift 2
+    cmake -S "$ROOT" -B "$dir" "$@" > "$dir.configure.log" 2>&1 \
+        || { cat "$dir.configure.log"; exit 1; }
+    cmake --build "$dir" --target headless -j"$JOBS" > "$dir.build.log" 2>&1 \
+        || { cat "$dir.build.log"; exit 1; }
+    mkdir -p "$BUILD_DIR/bin"
+    cp "$dir/headless" "$BUILD_DIR/bin/$name"
+}
+
+# replay every corpus file once through <headless>
+replay_corpus() {
+    for replay in "$CORPUS_DIR"/*.replay; do
+        "$1" --replay "$replay" --workers "$WORKERS" > /dev/null
+    done
+}
+
+# best of RUNS us/tick for <headless> on <replay>
+best_us_per_tick() {
+    local best=""
+    for ((run = 0; run < RUNS; run++)); do
+        local us
+        us="$("$1" --replay "$2" --workers "$WORKERS" | awk '/us\/tick:/ { for (i = 1; i < NF; i++) if ($i == "us/tick:") print $(i + 1) }')"
+        if [ -z "$best" ] || awk -v a="$us" -v b="$best" 'BEGIN { exit !(a < b) }'; then
+            best="$us"
+        fi
+    done
+    echo "$best"
+}
+
+mkdir -p "$BUILD_DIR"
+
+echo "== baseline: Release + LTO, no profile"
+build release release -DCMAKE_BUILD_TYPE=Release -DSI_LTO=ON -DSI_MARCH=
+
+if [ -z "$CORPUS_DIR" ]; then
+    CORPUS_DIR="$BUILD_DIR/corpus"
+    mkdir -p "$CORPUS_DIR"
+    echo "== recording corpus into $CORPUS_DIR"
+    # the default wave, a crowded screen, and a long run at a different seed and rate
+    "$BUILD_DIR/bin/release" --ticks 20000 --record "$CORPUS_DIR/default.replay" > /dev/null
+    "$BUILD_DIR/bin/release" --ticks 6000 --waves 16 --enemies 60 --bullets 4096 --seed 7 --record "$CORPUS_DIR/crowded.replay" > /dev/null
+    "$BUILD_DIR/bin/release" --ticks 40000 --hz 240 --seed 42 --record "$CORPUS_DIR/long.replay" > /dev/null
+fi
+if ! ls "$CORPUS_DIR"/*.replay > /dev/null 2>&1; then
+    echo "no .replay files in $CORPUS_DIR"
+    exit 1
+fi
+
+# pgo_variant <name> <cmake args...>: instrumented build, training run over
+# the corpus, then the PGO + LTO rebuild. gcc keys its profiles by object
+# path, so both builds share one tree; each variant trains on its own
+# binary since -march changes the code the profile describes.
+pgo_variant() {
+    local name="$1"
+    shift
+    local profiles="$BUILD_DIR/$name-profiles"
+    rm -rf "$profiles"
+    echo "== $name: instrumented build"
+    build "$name" "$name-instrumented" -DCMAKE_BUILD_TYPE=PGO -DSI_PGO_PHASE=generate -DSI_LTO=ON \
+        -DSI_PGO_DIR="$profiles" "$@"
+    echo "== $name: training on the corpus"
+    replay_corpus "$BUILD_DIR/bin/$name-instrumented"
+    if ls "$profiles"/*.profraw > /dev/null 2>&1; then
+        # clang
+        llvm-profdata merge -o "$profiles/default.profdata" "$profiles"/*.profraw
+    fi
+    echo "== $name: PGO + LTO build"
+    build "$name" "$name" -DSI_PGO_PHASE=use
+}
+
+pgo_variant pgo -DSI_MARCH=
+VARIANTS="release pgo"
+if [ -n "$MARCH" ]; then
+    pgo_variant pgo-march -DSI_MARCH="$MARCH"
+    VARIANTS="$VARIANTS pgo-march"
+fi
+
+echo
+printf "%-20s" "replay"
+for variant in $VARIANTS; do
+    printf " %12s %8s" "$variant us" "delta"
+done
+echo
+for replay in "$CORPUS_DIR"/*.replay; do
+    printf "%-20s" "$(basename "$replay" .replay)"
+    baseline=""
+    for variant in $VARIANTS; do
+        us="$(best_us_per_tick "$BUILD_DIR/bin/$variant" "$replay")"
+        if [ -z "$baseline" ]; then
+            baseline="$us"
+        fi
+        printf " %12s %7s%%" "$us" "$(awk -v a="$us" -v b="$baseline" 'BEGIN { printf "%+.1f", (b > 0) ? (a - b) * 100 / b : 0 }')"
+    done
+    echo
+done
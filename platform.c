@@ -0,0 +1,231 @@
+#ifndef _WIN32
+#    define _POSIX_C_SOURCE 200809L
+#endif
+
+#include "platform.h"
+
+#ifdef _WIN32
+#    define WIN32_LEAN_AND_MEAN
+#    include <windows.h>
+#else
+#    include <dlfcn.h>
+#    include <pthread.h>
+#    include <sched.h>
+#    include <stdlib.h>
+#    include <sys/stat.h>
+#    include <time.h>
+#    include <unistd.h>
+#endif
+#include <stdio.h>
+
+double platformGetSeconds(void)
+{
+#ifdef _WIN32
+	static LARGE_INTEGER frequency = {0};
+	LARGE_INTEGER counter;
+	if (frequency.QuadPart == 0)
+	{
+		QueryPerformanceFrequency(&frequency);
+	}
+	QueryPerformanceCounter(&counter);
+	return (double)counter.QuadPart / (double)frequency.QuadPart;
+#else
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+#endif
+}
+
+void platformSleepSeconds(double seconds)
+{
+	if (seconds <= 0.0)
+	{
+		return;
+	}
+#ifdef _WIN32
+	Sleep((DWORD)(seconds * 1000.0));
+#else
+	struct timespec ts;
+	ts.tv_sec = (time_t)seconds;
+	ts.tv_nsec = (long)((seconds - (double)ts.tv_sec) * 1e9);
+	nanosleep(&ts, NULL);
+#endif
+}
+
+void platformYieldThread(void)
+{
+#ifdef _WIN32
+	SwitchToThread();
+#else
+	sched_yield();
+#endif
+}
+
+// Logical processors available to this process, at least 1.
+int32_t platformCpuCount(void)
+{
+#ifdef _WIN32
+	SYSTEM_INFO info;
+	GetSystemInfo(&info);
+	int32_t count = (int32_t)info.dwNumberOfProcessors;
+#else
+	int32_t count = (int32_t)sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+	return (count > 0) ? count : 1;
+}
+
+// Threads are started with a plain int(void*) entry point on every platform;
+// the trampoline adapts it to what the OS expects.
+typedef struct ThreadStart
+{
+	PlatformThreadProc proc;
+	void *data;
+} ThreadStart;
+
+#ifdef _WIN32
+static DWORD WINAPI threadTrampoline(LPVOID parameter)
+{
+	ThreadStart start = *(ThreadStart *)parameter;
+	HeapFree(GetProcessHeap(), 0, parameter);
+	return (DWORD)start.proc(start.data);
+}
+#else
+static void *threadTrampoline(void *parameter)
+{
+	ThreadStart start = *(ThreadStart *)parameter;
+	free(parameter);
+	start.proc(start.data);
+	return NULL;
+}
+#endif
+
+bool platformStartThread(PlatformThread *thread, PlatformThreadProc proc, void *data)
+{
+#ifdef _WIN32
+	ThreadStart *start = (ThreadStart *)HeapAlloc(GetProcessHeap(), 0, sizeof(ThreadStart));
+	if (!start)
+	{
+		return false;
+	}
+	start->proc = proc;
+	start->data = data;
+	HANDLE handle = CreateThread(NULL, 0, threadTrampoline, start, 0, NULL);
+	if (!handle)
+	{
+		HeapFree(GetProcessHeap(), 0, start);
+		return false;
+	}
+	thread->handle = (uintptr_t)handle;
+	return true;
+#else
+	ThreadStart *start = (ThreadStart *)malloc(sizeof(ThreadStart));
+	if (!start)
+	{
+		return false;
+	}
+	start->proc = proc;
+	start->data = data;
+	pthread_t handle;
+	if (pthread_create(&handle, NULL, threadTrampoline, start) != 0)
+	{
+		free(start);
+		return false;
+	}
+	thread->handle = (uintptr_t)handle;
+	return true;
+#endif
+}
+
+void platformJoinThread(PlatformThread *thread)
+{
+#ifdef _WIN32
+	WaitForSingleObject((HANDLE)thread->handle, INFINITE);
+	CloseHandle((HANDLE)thread->handle);
+#else
+	pthread_join((pthread_t)thread->handle, NULL);
+#endif
+	thread->handle = 0;
+}
+
+// Shared libraries for the hot-reloadable game module. NULL on failure.
+void *platformLoadLibrary(const char *path)
+{
+#ifdef _WIN32
+	return (void *)LoadLibraryA(path);
+#else
+	return dlopen(path, RTLD_NOW | RTLD_LOCAL);
+#endif
+}
+
+void *platformLibrarySymbol(void *library, const char *name)
+{
+#ifdef _WIN32
+	return (void *)GetProcAddress((HMODULE)library, name);
+#else
+	return dlsym(library, name);
+#endif
+}
+
+void platformUnloadLibrary(void *library)
+{
+#ifdef _WIN32
+	FreeLibrary((HMODULE)library);
+#else
+	dlclose(library);
+#endif
+}
+
+// Last modification time in the OS's own units, only good for comparing
+// against another call; 0 if the file does not exist.
+int64_t platformFileWriteTime(const char *path)
+{
+#ifdef _WIN32
+	WIN32_FILE_ATTRIBUTE_DATA data;
+	if (!GetFileAttributesExA(path, GetFileExInfoStandard, &data))
+	{
+		return 0;
+	}
+	return ((int64_t)data.ftLastWriteTime.dwHighDateTime << 32) | data.ftLastWriteTime.dwLowDateTime;
+#else
+	struct stat info;
+	if (stat(path, &info) != 0)
+	{
+		return 0;
+	}
+	return (int64_t)info.st_mtim.tv_sec * 1000000000 + info.st_mtim.tv_nsec;
+#endif
+}
+
+bool platformCopyFile(const char *from, const char *to)
+{
+#ifdef _WIN32
+	return CopyFileA(from, to, FALSE) != 0;
+#else
+	FILE *source = fopen(from, "rb");
+	if (!source)
+	{
+		return false;
+	}
+	FILE *target = fopen(to, "wb");
+	if (!target)
+	{
+		fclose(source);
+		return false;
+	}
+	char buffer[64 * 1024];
+	size_t read;
+	bool ok = true;
+	while ((read = fread(buffer, 1, sizeof(buffer), source)) > 0)
+	{
+		if (fwrite(buffer, 1, read, target) != read)
+		{
+			ok = false;
+			break;
+		}
+	}
+	ok = ok && !ferror(source);
+	fclose(source);
+	ok = (fclose(target) == 0) && ok;
+	return ok;
+#endif
+}
@@ -0,0 +1,34 @@
+#ifndef PLATFORM_H
+#define PLATFORM_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Small OS layer for code that must not depend on a raylib window
+// (headless runner, benchmarks, worker threads). Kept out of raylib.h's way
+// so the implementation is free to include OS headers.
+
+typedef int (*PlatformThreadProc)(void *data);
+
+typedef struct PlatformThread
+{
+	uintptr_t handle;
+} PlatformThread;
+
+//functions==================
+//
+double platformGetSeconds(void);
+void platformSleepSeconds(double seconds);
+void platformYieldThread(void);
+int32_t platformCpuCount(void);
+bool platformStartThread(PlatformThread *thread, PlatformThreadProc proc, void *data);
+void platformJoinThread(PlatformThread *thread);
+void *platformLoadLibrary(const char *path);
+void *platformLibrarySymbol(void *library, const char *name);
+void platformUnloadLibrary(void *library);
+int64_t platformFileWriteTime(const char *path);
+bool platformCopyFile(const char *from, const char *to);
+//
+//===========================
+
+#endif
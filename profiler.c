@@ -0,0 +1,102 @@
+#include "profiler.h"
+#include "platform.h"
+#include <stdlib.h>
+#include <string.h>
+
+static const char *phaseNames[ProfilePhaseCount] = {
+	"sim_tick", "sim_player", "sim_bullets", "sim_waves", "sim_collision", "sim_cull", "sim_record",
+	"frame", "frame_input", "frame_draw", "frame_swap",
+};
+
+void initProfiler(Profiler *profiler)
+{
+	memset(profiler, 0, sizeof(*profiler));
+}
+
+void beginProfilePhase(Profiler *profiler, ProfilePhase phase)
+{
+	if (profiler)
+	{
+		profiler->phaseStart[phase] = platformGetSeconds();
+	}
+}
+
+void endProfilePhase(Profiler *profiler, ProfilePhase phase)
+{
+	if (profiler)
+	{
+		addProfileSample(profiler, phase, (float)((platformGetSeconds() - profiler->phaseStart[phase]) * 1000.0));
+	}
+}
+
+void addProfileSample(Profiler *profiler, ProfilePhase phase, float ms)
+{
+	if (!profiler)
+	{
+		return;
+	}
+	ProfileWindow *window = &profiler->windows[phase];
+	window->samples[window->next] = ms;
+	window->next = (window->next + 1) % PROFILE_WINDOW;
+	if (window->count < PROFILE_WINDOW)
+	{
+		window->count++;
+	}
+	profiler->last[phase] = ms;
+}
+
+static int compareFloats(const void *a, const void *b)
+{
+	float x = *(const float *)a;
+	float y = *(const float *)b;
+	return (x > y) - (x < y);
+}
+
+// Nearest-rank percentiles over the current window. Sorts a copy, so call
+// it a few times a second rather than per phase per frame.
+ProfileStats profilePhaseStats(const Profiler *profiler, ProfilePhase phase)
+{
+	ProfileStats stats = {0};
+	const ProfileWindow *window = &profiler->windows[phase];
+	if (window->count == 0)
+	{
+		return stats;
+	}
+
+	float sorted[PROFILE_WINDOW];
+	memcpy(sorted, window->samples, sizeof(float) * window->count);
+	qsort(sorted, window->count, sizeof(float), compareFloats);
+	stats.last = profiler->last[phase];
+	stats.p50 = sorted[(window->count - 1) * 50 / 100];
+	stats.p99 = sorted[(window->count - 1) * 99 / 100];
+	return stats;
+}
+
+const char *profilePhaseName(ProfilePhase phase)
+{
+	return phaseNames[phase];
+}
+
+void writeProfileCsvHeader(FILE *file)
+{
+	fprintf(file, "time");
+	for (int phase = 0; phase < ProfilePhaseCount; phase++)
+	{
+		fprintf(file, ",%s_p50_ms,%s_p99_ms", phaseNames[phase], phaseNames[phase]);
+	}
+	fprintf(file, "\n");
+}
+
+// One row of every phase's p50 and p99 over its current window; phases with
+// no samples yet come out as zero.
+void writeProfileCsvRow(FILE *file, const Profiler *profiler, double time)
+{
+	fprintf(file, "%.3f", time);
+	for (int phase = 0; phase < ProfilePhaseCount; phase++)
+	{
+		ProfileStats stats = profilePhaseStats(profiler, (ProfilePhase)phase);
+		fprintf(file, ",%.4f,%.4f", stats.p50, stats.p99);
+	}
+	fprintf(file, "\n");
+	fflush(file);
+}
@@ -0,0 +1,72 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+// Per-phase frame timing. Each phase keeps a rolling window of its last
+// PROFILE_WINDOW samples in milliseconds, from which the overlay and the CSV
+// export take last / p50 / p99. A Profiler belongs to one thread: the sim
+// thread times its phases into its own, and hands the per-tick samples to
+// the render thread's through the frame snapshot. Timing uses
+// platformGetSeconds, a monotonic counter on every platform; a NULL
+// profiler makes every call a no-op.
+
+#define PROFILE_WINDOW 256
+
+typedef enum
+{
+	// sim thread, once per tick unless noted
+	PROFILE_SIM_TICK,
+	PROFILE_SIM_PLAYER,
+	PROFILE_SIM_BULLETS,
+	PROFILE_SIM_WAVES,
+	PROFILE_SIM_COLLISION,
+	PROFILE_SIM_CULL,
+	// once per published snapshot
+	PROFILE_SIM_RECORD,
+
+	// render thread, once per frame
+	PROFILE_FRAME,
+	PROFILE_FRAME_INPUT,
+	PROFILE_FRAME_DRAW,
+	PROFILE_FRAME_SWAP,
+	ProfilePhaseCount
+} ProfilePhase;
+
+typedef struct ProfileWindow
+{
+	float samples[PROFILE_WINDOW];
+	int32_t next;
+	int32_t count;
+} ProfileWindow;
+
+typedef struct ProfileStats
+{
+	float last;
+	float p50;
+	float p99;
+} ProfileStats;
+
+typedef struct Profiler
+{
+	double phaseStart[ProfilePhaseCount];
+	float last[ProfilePhaseCount];
+	ProfileWindow windows[ProfilePhaseCount];
+} Profiler;
+
+//functions==================
+//
+void initProfiler(Profiler *profiler);
+void beginProfilePhase(Profiler *profiler, ProfilePhase phase);
+void endProfilePhase(Profiler *profiler, ProfilePhase phase);
+void addProfileSample(Profiler *profiler, ProfilePhase phase, float ms);
+ProfileStats profilePhaseStats(const Profiler *profiler, ProfilePhase phase);
+const char *profilePhaseName(ProfilePhase phase);
+void writeProfileCsvHeader(FILE *file);
+void writeProfileCsvRow(FILE *file, const Profiler *profiler, double time);
+//
+//===========================
+
+#endif
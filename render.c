@@ -0,0 +1,129 @@
+#include "render.h"
+#include "rlgl.h"
+#define RAYMATH_STATIC_INLINE
+#include "raymath.h"
+
+static const char *enemyVertexShader =
+	"#version 330\n"
+	"in vec2 vertexPosition;\n"
+	"in vec2 instanceOffset;\n"
+	"uniform mat4 mvp;\n"
+	"void main()\n"
+	"{\n"
+	"    gl_Position = mvp*vec4(vertexPosition + instanceOffset, 0.0, 1.0);\n"
+	"}\n";
+
+static const char *enemyFragmentShader =
+	"#version 330\n"
+	"uniform vec4 color;\n"
+	"out vec4 finalColor;\n"
+	"void main()\n"
+	"{\n"
+	"    finalColor = color;\n"
+	"}\n";
+
+// scratch only backs the triangulated outlines until they are uploaded.
+bool initEnemyRenderer(EnemyRenderer *renderer, MemoryArena *scratch, int instanceCapacity)
+{
+	*renderer = (EnemyRenderer){0};
+
+	int version = rlGetVersion();
+	if (version != RL_OPENGL_33 && version != RL_OPENGL_43)
+	{
+		return false;
+	}
+
+	renderer->shader = rlLoadShaderCode(enemyVertexShader, enemyFragmentShader);
+	if (renderer->shader == 0 || renderer->shader == rlGetShaderIdDefault())
+	{
+		return false;
+	}
+	renderer->mvpLocation = rlGetLocationUniform(renderer->shader, "mvp");
+	renderer->colorLocation = rlGetLocationUniform(renderer->shader, "color");
+	int positionLocation = rlGetLocationAttrib(renderer->shader, "vertexPosition");
+	int offsetLocation = rlGetLocationAttrib(renderer->shader, "instanceOffset");
+	renderer->instanceCapacity = instanceCapacity;
+
+	for (int type = 0; type < EnemyTypeCount; type++)
+	{
+		// fan to triangle list, the same split DrawTriangleFan() makes
+		const Shape *shape = &enemyShapes[type];
+		ArenaMark mark = arenaMark(scratch);
+		Vector2 *triangles = PushArray(scratch, 3 * (shape->pointCount - 2), Vector2);
+		int vertexCount = 0;
+		for (int i = 1; i < shape->pointCount - 1; i++)
+		{
+			triangles[vertexCount++] = shape->points[0];
+			triangles[vertexCount++] = shape->points[i];
+			triangles[vertexCount++] = shape->points[i + 1];
+		}
+		renderer->vertexCount[type] = vertexCount;
+
+		renderer->vertexArray[type] = rlLoadVertexArray();
+		rlEnableVertexArray(renderer->vertexArray[type]);
+
+		renderer->shapeBuffer[type] = rlLoadVertexBuffer(triangles, vertexCount * sizeof(Vector2), false);
+		rlSetVertexAttribute(positionLocation, 2, RL_FLOAT, false, 0, 0);
+		rlEnableVertexAttribute(positionLocation);
+
+		renderer->instanceBuffer[type] = rlLoadVertexBuffer(NULL, instanceCapacity * sizeof(Vector2), true);
+		rlSetVertexAttribute(offsetLocation, 2, RL_FLOAT, false, 0, 0);
+		rlEnableVertexAttribute(offsetLocation);
+		rlSetVertexAttributeDivisor(offsetLocation, 1);
+
+		rlDisableVertexArray();
+		arenaRewind(mark);
+	}
+
+	renderer->ready = true;
+	return true;
+}
+
+// Draws count instances of type's outline translated by offsets, in as many
+// draws as instanceCapacity requires (one for any normal wave).
+void drawEnemyInstances(EnemyRenderer *renderer, int32_t type, const Vector2 *offsets, int count, Color color)
+{
+	if (count <= 0)
+	{
+		return;
+	}
+
+	// anything already queued in the immediate-mode batch goes first
+	rlDrawRenderBatchActive();
+
+	rlEnableShader(renderer->shader);
+	rlSetUniformMatrix(renderer->mvpLocation, MatrixMultiply(rlGetMatrixModelview(), rlGetMatrixProjection()));
+	float tint[4] = { color.r / 255.0f, color.g / 255.0f, color.b / 255.0f, color.a / 255.0f };
+	rlSetUniform(renderer->colorLocation, tint, RL_SHADER_UNIFORM_VEC4, 1);
+
+	rlEnableVertexArray(renderer->vertexArray[type]);
+	for (int first = 0; first < count; first += renderer->instanceCapacity)
+	{
+		int instances = count - first;
+		if (instances > renderer->instanceCapacity)
+		{
+			instances = renderer->instanceCapacity;
+		}
+		rlUpdateVertexBuffer(renderer->instanceBuffer[type], offsets + first, instances * sizeof(Vector2), 0);
+		rlDrawVertexArrayInstanced(0, renderer->vertexCount[type], instances);
+	}
+	rlDisableVertexArray();
+	rlDisableShader();
+}
+
+void unloadEnemyRenderer(EnemyRenderer *renderer)
+{
+	if (!renderer->ready)
+	{
+		return;
+	}
+
+	for (int type = 0; type < EnemyTypeCount; type++)
+	{
+		rlUnloadVertexBuffer(renderer->instanceBuffer[type]);
+		rlUnloadVertexBuffer(renderer->shapeBuffer[type]);
+		rlUnloadVertexArray(renderer->vertexArray[type]);
+	}
+	rlUnloadShaderProgram(renderer->shader);
+	renderer->ready = false;
+}
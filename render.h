@@ -0,0 +1,38 @@
+#ifndef RENDER_H
+#define RENDER_H
+
+#include "raylib.h"
+#include "shapes.h"
+#include "arena.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+#define ENEMY_INSTANCE_CAPACITY 4096
+
+// Instanced enemy drawing. Each enemy type's outline is uploaded once as a
+// triangle list; per frame only the instance offsets are streamed and a
+// whole wave of one type goes out as a single instanced draw, so the draw
+// call count does not grow with the wave. Needs desktop GL 3.3+, ready stays
+// false elsewhere and callers fall back to immediate mode.
+typedef struct EnemyRenderer
+{
+	bool ready;
+	unsigned int shader;
+	int mvpLocation;
+	int colorLocation;
+	unsigned int vertexArray[EnemyTypeCount];
+	unsigned int shapeBuffer[EnemyTypeCount];
+	unsigned int instanceBuffer[EnemyTypeCount];
+	int vertexCount[EnemyTypeCount];
+	int instanceCapacity;
+} EnemyRenderer;
+
+//functions==================
+//
+bool initEnemyRenderer(EnemyRenderer *renderer, MemoryArena *scratch, int instanceCapacity);
+void drawEnemyInstances(EnemyRenderer *renderer, int32_t type, const Vector2 *offsets, int count, Color color);
+void unloadEnemyRenderer(EnemyRenderer *renderer);
+//
+//===========================
+
+#endif
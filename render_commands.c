@@ -0,0 +1,167 @@
+#include "render_commands.h"
+#include <string.h>
+
+bool initRenderCommandBuffer(RenderCommandBuffer *buffer, MemoryArena *arena, int32_t capacity)
+{
+	buffer->commands = PushArray(arena, capacity, RenderCommand);
+	buffer->count = 0;
+	buffer->capacity = buffer->commands ? capacity : 0;
+	return buffer->commands != NULL;
+}
+
+// Key is type, then shape, then recording order, so sorting groups commands
+// by GL state while keeping a deterministic order inside each group.
+static RenderCommand *pushCommand(RenderCommandBuffer *buffer, RenderCommandType type, ShapeId shape)
+{
+	if (buffer->count >= buffer->capacity)
+	{
+		return NULL;
+	}
+
+	RenderCommand *command = &buffer->commands[buffer->count];
+	command->sortKey = ((uint64_t)type << 56) | ((uint64_t)shape << 48) | (uint64_t)buffer->count;
+	command->type = (uint8_t)type;
+	command->shape = (uint8_t)shape;
+	buffer->count++;
+	return command;
+}
+
+// motion is how far the thing moved during the tick being recorded.
+void pushRectCommand(RenderCommandBuffer *buffer, Rectangle rect, Vector2 motion, Color color)
+{
+	RenderCommand *command = pushCommand(buffer, RENDER_RECT, SHAPE_NONE);
+	if (command)
+	{
+		command->color = color;
+		command->previous = (Vector2){ rect.x - motion.x, rect.y - motion.y };
+		command->position = (Vector2){ rect.x, rect.y };
+		command->size = (Vector2){ rect.width, rect.height };
+	}
+}
+
+void pushRectLinesCommand(RenderCommandBuffer *buffer, Rectangle rect, Vector2 motion, Color color)
+{
+	RenderCommand *command = pushCommand(buffer, RENDER_RECT_LINES, SHAPE_NONE);
+	if (command)
+	{
+		command->color = color;
+		command->previous = (Vector2){ rect.x - motion.x, rect.y - motion.y };
+		command->position = (Vector2){ rect.x, rect.y };
+		command->size = (Vector2){ rect.width, rect.height };
+	}
+}
+
+void pushOutlineCommand(RenderCommandBuffer *buffer, ShapeId shape, Vector2 position, Vector2 motion, Color color)
+{
+	RenderCommand *command = pushCommand(buffer, RENDER_OUTLINE, shape);
+	if (command)
+	{
+		command->color = color;
+		command->previous = (Vector2){ position.x - motion.x, position.y - motion.y };
+		command->position = position;
+		command->size = (Vector2){ 0.0f, 0.0f };
+	}
+}
+
+// LSD radix sort on the top 16 key bits (type, shape). Stable, so recording
+// order survives inside each group without sorting on the low bits.
+void sortRenderCommands(RenderCommandBuffer *buffer, MemoryArena *scratch)
+{
+	if (buffer->count < 2)
+	{
+		return;
+	}
+
+	ArenaMark mark = arenaMark(scratch);
+	RenderCommand *temp = PushArray(scratch, buffer->count, RenderCommand);
+	if (!temp)
+	{
+		// unsorted still draws right, just with more state changes
+		return;
+	}
+	RenderCommand *from = buffer->commands;
+	RenderCommand *to = temp;
+
+	for (int shift = 48; shift < 64; shift += 8)
+	{
+		int32_t offsets[257] = {0};
+		for (int32_t i = 0; i < buffer->count; i++)
+		{
+			offsets[((from[i].sortKey >> shift) & 0xFF) + 1]++;
+		}
+		for (int bucket = 0; bucket < 256; bucket++)
+		{
+			offsets[bucket + 1] += offsets[bucket];
+		}
+		for (int32_t i = 0; i < buffer->count; i++)
+		{
+			to[offsets[(from[i].sortKey >> shift) & 0xFF]++] = from[i];
+		}
+
+		RenderCommand *swap = from;
+		from = to;
+		to = swap;
+	}
+
+	// two passes, so the sorted result is back in buffer->commands
+	arenaRewind(mark);
+}
+
+Vector2 interpolatedPosition(const RenderCommand *command, float alpha)
+{
+	return (Vector2){
+		command->previous.x + (command->position.x - command->previous.x) * alpha,
+		command->previous.y + (command->position.y - command->previous.y) * alpha
+	};
+}
+
+// Upper bound on what recordRenderCommands can push for this state.
+int32_t renderCommandCapacity(const State *state)
+{
+	return 2 + state->playerBullets.capacity + 2 * state->enemyCount;
+}
+
+// Refills buffer with everything visible in state after a tick of dt. Only
+// reads state.
+void recordRenderCommands(const State *state, RenderCommandBuffer *buffer, bool showColliders, float dt)
+{
+	const Player *player = statePlayer(state);
+	const BulletPool *bullets = &state->playerBullets;
+	buffer->count = 0;
+
+	Vector2 playerMotion = { player->position.x - player->previousPosition.x, player->position.y - player->previousPosition.y };
+	if (showColliders)
+	{
+		pushRectLinesCommand(buffer, player->collider, playerMotion, RED);
+	}
+	pushOutlineCommand(buffer, SHAPE_PLAYER, player->position, playerMotion, BLUE);
+
+	for (int32_t i = 0; i < bullets->count; i++)
+	{
+		pushRectCommand(buffer, bulletCollider(bullets, i), bulletMotion(bullets, i, dt), RED);
+	}
+
+	const EnemyWave *waves = stateWaves(state);
+	for (int32_t w = 0; w < state->waveCount; w++)
+	{
+		// enemies only ever move with their wave
+		const EnemyWave *wave = &waves[w];
+		const Enemy *enemies = waveEnemies(state, wave);
+		Vector2 waveMotion = {
+			wave->wave_position.x - wave->previous_wave_position.x,
+			wave->wave_position.y - wave->previous_wave_position.y
+		};
+		for (int32_t i = 0; i < wave->enemy_number; i++)
+		{
+			const Enemy *enemy = &enemies[i];
+			if (enemy->active)
+			{
+				if (showColliders)
+				{
+					pushRectLinesCommand(buffer, enemyCollider(wave, enemy), waveMotion, RED);
+				}
+				pushOutlineCommand(buffer, (ShapeId)enemy->type, enemyPosition(wave, enemy), waveMotion, GREEN);
+			}
+		}
+	}
+}
@@ -0,0 +1,68 @@
+#ifndef RENDER_COMMANDS_H
+#define RENDER_COMMANDS_H
+
+#include "raylib.h"
+#include "arena.h"
+#include "shapes.h"
+#include "sim.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+// Everything the renderer draws for a frame, recorded from a read-only view
+// of the game state. Recording touches no graphics API, so it can happen on
+// any thread; executing the buffer is the only place that talks to raylib.
+
+typedef enum
+{
+	// enum order is submission order, so batched geometry is grouped ahead
+	// of the instanced outlines that force a batch flush
+	RENDER_RECT,
+	RENDER_RECT_LINES,
+	RENDER_OUTLINE,
+} RenderCommandType;
+
+// What RENDER_OUTLINE draws. Enemy types map straight onto their ids so
+// runs of one type can be drawn as a single instanced batch.
+typedef enum
+{
+	SHAPE_ALIEN = Alien,
+	SHAPE_BOSS = Boss,
+	SHAPE_PLAYER = EnemyTypeCount,
+	SHAPE_NONE,
+} ShapeId;
+
+typedef struct RenderCommand
+{
+	uint64_t sortKey;
+	uint8_t type;
+	uint8_t shape;
+	Color color;
+	// where the thing was at the start of the tick that produced it, so a
+	// renderer running between ticks can interpolate towards position
+	Vector2 previous;
+	Vector2 position;
+	// rect size for RENDER_RECT / RENDER_RECT_LINES, unused for outlines
+	Vector2 size;
+} RenderCommand;
+
+typedef struct RenderCommandBuffer
+{
+	RenderCommand *commands;
+	int32_t count;
+	int32_t capacity;
+} RenderCommandBuffer;
+
+//functions==================
+//
+bool initRenderCommandBuffer(RenderCommandBuffer *buffer, MemoryArena *arena, int32_t capacity);
+void pushRectCommand(RenderCommandBuffer *buffer, Rectangle rect, Vector2 motion, Color color);
+void pushRectLinesCommand(RenderCommandBuffer *buffer, Rectangle rect, Vector2 motion, Color color);
+void pushOutlineCommand(RenderCommandBuffer *buffer, ShapeId shape, Vector2 position, Vector2 motion, Color color);
+void sortRenderCommands(RenderCommandBuffer *buffer, MemoryArena *scratch);
+int32_t renderCommandCapacity(const State *state);
+void recordRenderCommands(const State *state, RenderCommandBuffer *buffer, bool showColliders, float dt);
+Vector2 interpolatedPosition(const RenderCommand *command, float alpha);
+//
+//===========================
+
+#endif
@@ -0,0 +1,237 @@
+#include "replay.h"
+#include <stdlib.h>
+#include <string.h>
+
+static void putU16(uint8_t *out, uint16_t value)
+{
+	out[0] = (uint8_t)value;
+	out[1] = (uint8_t)(value >> 8);
+}
+
+static void putU32(uint8_t *out, uint32_t value)
+{
+	for (int i = 0; i < 4; i++)
+	{
+		out[i] = (uint8_t)(value >> (8 * i));
+	}
+}
+
+static void putU64(uint8_t *out, uint64_t value)
+{
+	for (int i = 0; i < 8; i++)
+	{
+		out[i] = (uint8_t)(value >> (8 * i));
+	}
+}
+
+static uint16_t getU16(const uint8_t *in)
+{
+	return (uint16_t)(in[0] | (in[1] << 8));
+}
+
+static uint32_t getU32(const uint8_t *in)
+{
+	uint32_t value = 0;
+	for (int i = 0; i < 4; i++)
+	{
+		value |= (uint32_t)in[i] << (8 * i);
+	}
+	return value;
+}
+
+static uint64_t getU64(const uint8_t *in)
+{
+	uint64_t value = 0;
+	for (int i = 0; i < 8; i++)
+	{
+		value |= (uint64_t)in[i] << (8 * i);
+	}
+	return value;
+}
+
+static bool writeHeader(FILE *file, const ReplayHeader *header)
+{
+	uint8_t bytes[REPLAY_HEADER_SIZE];
+	memcpy(bytes, REPLAY_MAGIC, 4);
+	putU16(bytes + 4, header->version);
+	putU16(bytes + 6, header->hz);
+	putU32(bytes + 8, header->seed);
+	putU32(bytes + 12, (uint32_t)header->bulletCapacity);
+	putU32(bytes + 16, (uint32_t)header->waveCount);
+	putU32(bytes + 20, (uint32_t)header->enemyCount);
+	putU64(bytes + 24, header->tickCount);
+	putU64(bytes + 32, header->finalHash);
+	return fwrite(bytes, 1, sizeof(bytes), file) == sizeof(bytes);
+}
+
+static void writeRun(ReplayWriter *writer)
+{
+	fputc(writer->runButtons, writer->file);
+	uint64_t extra = writer->runLength - 1;
+	do
+	{
+		uint8_t byte = (uint8_t)(extra & 0x7F);
+		extra >>= 7;
+		fputc(extra ? (byte | 0x80) : byte, writer->file);
+	} while (extra);
+}
+
+// Writes a provisional header; tick count and hash are filled in on close.
+bool openReplayWriter(ReplayWriter *writer, const char *path, const SimConfig *config, int hz)
+{
+	memset(writer, 0, sizeof(*writer));
+	writer->file = fopen(path, "wb");
+	if (!writer->file)
+	{
+		return false;
+	}
+	writer->header.version = REPLAY_VERSION;
+	writer->header.hz = (uint16_t)hz;
+	writer->header.seed = config->seed;
+	writer->header.bulletCapacity = config->bulletCapacity;
+	writer->header.waveCount = config->waveCount;
+	writer->header.enemyCount = config->enemyCount;
+	if (!writeHeader(writer->file, &writer->header))
+	{
+		fclose(writer->file);
+		writer->file = NULL;
+		return false;
+	}
+	return true;
+}
+
+// Call once per SimStep with the exact input that step was given.
+void recordReplayInput(ReplayWriter *writer, const InputFrame *input)
+{
+	if (!writer->file)
+	{
+		return;
+	}
+	if (writer->runLength > 0 && input->buttons != writer->runButtons)
+	{
+		writeRun(writer);
+		writer->runLength = 0;
+	}
+	writer->runButtons = input->buttons;
+	writer->runLength++;
+	writer->header.tickCount++;
+}
+
+bool closeReplayWriter(ReplayWriter *writer, uint64_t finalHash)
+{
+	if (!writer->file)
+	{
+		return false;
+	}
+	if (writer->runLength > 0)
+	{
+		writeRun(writer);
+	}
+	writer->header.finalHash = finalHash;
+	bool ok = fseek(writer->file, 0, SEEK_SET) == 0 && writeHeader(writer->file, &writer->header);
+	ok = (fclose(writer->file) == 0) && ok;
+	writer->file = NULL;
+	return ok;
+}
+
+// Reads the whole file; it stays in memory until unloadReplay. Fails for a
+// header whose tick rate or config the hosts could not run.
+bool loadReplay(ReplayReader *reader, const char *path)
+{
+	memset(reader, 0, sizeof(*reader));
+	FILE *file = fopen(path, "rb");
+	if (!file)
+	{
+		return false;
+	}
+	bool ok = fseek(file, 0, SEEK_END) == 0;
+	long size = ok ? ftell(file) : -1;
+	ok = ok && size >= REPLAY_HEADER_SIZE && fseek(file, 0, SEEK_SET) == 0;
+	if (ok)
+	{
+		reader->data = (uint8_t *)malloc((size_t)size);
+		ok = reader->data && fread(reader->data, 1, (size_t)size, file) == (size_t)size;
+	}
+	fclose(file);
+	if (!ok || memcmp(reader->data, REPLAY_MAGIC, 4) != 0 || getU16(reader->data + 4) != REPLAY_VERSION)
+	{
+		unloadReplay(reader);
+		return false;
+	}
+
+	const uint8_t *bytes = reader->data;
+	reader->header.version = getU16(bytes + 4);
+	reader->header.hz = getU16(bytes + 6);
+	reader->header.seed = getU32(bytes + 8);
+	reader->header.bulletCapacity = (int32_t)getU32(bytes + 12);
+	reader->header.waveCount = (int32_t)getU32(bytes + 16);
+	reader->header.enemyCount = (int32_t)getU32(bytes + 20);
+	reader->header.tickCount = getU64(bytes + 24);
+	reader->header.finalHash = getU64(bytes + 32);
+	reader->at = REPLAY_HEADER_SIZE;
+	reader->size = (size_t)size;
+
+	// a damaged or hand-edited header must not get to size the run
+	SimConfig config = replayConfig(&reader->header);
+	if (reader->header.hz == 0 || !validSimConfig(&config) || stateBytes(&config) > PERMANENT_STORAGE_SIZE)
+	{
+		unloadReplay(reader);
+		return false;
+	}
+	return true;
+}
+
+void unloadReplay(ReplayReader *reader)
+{
+	free(reader->data);
+	reader->data = NULL;
+	reader->size = 0;
+	reader->at = 0;
+}
+
+// Input for the next tick. Returns false once the recorded ticks run out or
+// the run data is truncated.
+bool nextReplayInput(ReplayReader *reader, InputFrame *input)
+{
+	if (reader->ticksRead >= reader->header.tickCount)
+	{
+		return false;
+	}
+	if (reader->runRemaining == 0)
+	{
+		if (reader->at >= reader->size)
+		{
+			return false;
+		}
+		reader->runButtons = reader->data[reader->at++];
+		uint64_t extra = 0;
+		int shift = 0;
+		uint8_t byte;
+		do
+		{
+			if (reader->at >= reader->size || shift > 63)
+			{
+				return false;
+			}
+			byte = reader->data[reader->at++];
+			extra |= (uint64_t)(byte & 0x7F) << shift;
+			shift += 7;
+		} while (byte & 0x80);
+		reader->runRemaining = extra + 1;
+	}
+	input->buttons = reader->runButtons;
+	reader->runRemaining--;
+	reader->ticksRead++;
+	return true;
+}
+
+// The config the recorded session was started with.
+SimConfig replayConfig(const ReplayHeader *header)
+{
+	SimConfig config = defaultSimConfig();
+	config.seed = header->seed;
+	config.bulletCapacity = header->bulletCapacity;
+	config.waveCount = header->waveCount;
+	config.enemyCount = header->enemyCount;
+	return config;
+}
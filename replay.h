@@ -0,0 +1,82 @@
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include "sim.h"
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+// Session recordings. The sim is a pure function of its config, seed and
+// the per-tick InputFrame stream, so that is all a replay stores; running
+// it back through SimStep at the recorded tick rate reproduces the session
+// bit for bit, and the final state hash says whether it did.
+//
+// File layout, little endian:
+//   0  "SIRP"            magic
+//   4  u16 version
+//   6  u16 hz            ticks per second the session was simulated at
+//   8  u32 seed
+//  12  i32 bulletCapacity
+//  16  i32 waveCount
+//  20  i32 enemyCount    per wave
+//  24  u64 tickCount
+//  32  u64 finalHash     hashState() after the last tick
+//  40  runs until end of file, one per input change: the buttons byte, then
+//      how many further ticks held it as an unsigned LEB128 varint
+//
+// Input only changes on key edges, so a minute of play is usually a few
+// hundred bytes.
+
+#define REPLAY_MAGIC "SIRP"
+// 2: wave randomness moved from rand() to a per-wave Rng
+// 3: waveCount added to the header
+// 4: waves move as rigid formations
+// 5: finalHash covers each wave's tween target
+#define REPLAY_VERSION 5
+#define REPLAY_HEADER_SIZE 40
+
+typedef struct ReplayHeader
+{
+	uint16_t version;
+	uint16_t hz;
+	uint32_t seed;
+	int32_t bulletCapacity;
+	int32_t waveCount;
+	int32_t enemyCount;
+	uint64_t tickCount;
+	uint64_t finalHash;
+} ReplayHeader;
+
+typedef struct ReplayWriter
+{
+	FILE *file;
+	ReplayHeader header;
+	// the run being accumulated, flushed when the input changes
+	uint8_t runButtons;
+	uint64_t runLength;
+} ReplayWriter;
+
+typedef struct ReplayReader
+{
+	ReplayHeader header;
+	uint8_t *data;
+	size_t at;
+	size_t size;
+	uint8_t runButtons;
+	uint64_t runRemaining;
+	uint64_t ticksRead;
+} ReplayReader;
+
+//functions==================
+//
+bool openReplayWriter(ReplayWriter *writer, const char *path, const SimConfig *config, int hz);
+void recordReplayInput(ReplayWriter *writer, const InputFrame *input);
+bool closeReplayWriter(ReplayWriter *writer, uint64_t finalHash);
+bool loadReplay(ReplayReader *reader, const char *path);
+void unloadReplay(ReplayReader *reader);
+bool nextReplayInput(ReplayReader *reader, InputFrame *input);
+SimConfig replayConfig(const ReplayHeader *header);
+//
+//===========================
+
+#endif
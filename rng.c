@@ -0,0 +1,169 @@
+#include "rng.h"
+#include <string.h>
+
+#if defined(__AVX2__)
+#    include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#    include <emmintrin.h>
+#endif
+
+#define PCG_MULTIPLIER 6364136223846793005ull
+
+// Top 24 bits of a draw scaled to [0, 1); exact in a float.
+#define RNG_UNIT_SCALE (1.0f / 16777216.0f)
+
+// Standard PCG32 seeding. Different streams give unrelated sequences from
+// the same seed, so systems can share the run's seed.
+void seedRng(Rng *rng, uint64_t seed, uint64_t stream)
+{
+	rng->state = 0;
+	rng->increment = (stream << 1) | 1u;
+	nextRandom(rng);
+	rng->state += seed;
+	nextRandom(rng);
+}
+
+uint32_t nextRandom(Rng *rng)
+{
+	uint64_t old = rng->state;
+	rng->state = old * PCG_MULTIPLIER + rng->increment;
+	uint32_t xorshifted = (uint32_t)(((old >> 18) ^ old) >> 27);
+	uint32_t rotation = (uint32_t)(old >> 59);
+	return (xorshifted >> rotation) | (xorshifted << ((32 - rotation) & 31));
+}
+
+float randomUnit(Rng *rng)
+{
+	return (float)(nextRandom(rng) >> 8) * RNG_UNIT_SCALE;
+}
+
+// Seeds every lane from draws on source; xoshiro only needs a state that is
+// not all zero, which four PCG draws per lane make vanishingly unlikely.
+void seedRngLanes(RngLanes *lanes, Rng *source)
+{
+	for (int lane = 0; lane < RNG_LANES; lane++)
+	{
+		lanes->s0[lane] = nextRandom(source);
+		lanes->s1[lane] = nextRandom(source);
+		lanes->s2[lane] = nextRandom(source);
+		lanes->s3[lane] = nextRandom(source) | 1u;
+	}
+}
+
+#if !defined(__AVX2__) && !defined(__SSE2__) && !defined(_M_X64)
+// Scalar xoshiro128+ step for one lane; the vector paths below do exactly
+// this to every lane at once, so all three produce the same numbers.
+static float stepLane(RngLanes *lanes, int lane, float min, float scale)
+{
+	uint32_t s0 = lanes->s0[lane];
+	uint32_t s1 = lanes->s1[lane];
+	uint32_t s2 = lanes->s2[lane];
+	uint32_t s3 = lanes->s3[lane];
+	uint32_t result = s0 + s3;
+	uint32_t t = s1 << 9;
+	s2 ^= s0;
+	s3 ^= s1;
+	s1 ^= s2;
+	s0 ^= s3;
+	s2 ^= t;
+	s3 = (s3 << 11) | (s3 >> 21);
+	lanes->s0[lane] = s0;
+	lanes->s1[lane] = s1;
+	lanes->s2[lane] = s2;
+	lanes->s3[lane] = s3;
+	return min + (float)(result >> 8) * scale;
+}
+#endif
+
+// Writes count uniform floats in [min, max). Every call steps all lanes a
+// whole number of times, so output depends only on the lanes' seed and the
+// counts asked for, not on which path compiled.
+void fillRandomFloats(RngLanes *lanes, float *out, int32_t count, float min, float max)
+{
+	float scale = (max - min) * RNG_UNIT_SCALE;
+	int32_t i = 0;
+	_Alignas(32) float tail[RNG_LANES];
+
+#if defined(__AVX2__)
+	__m256i s0 = _mm256_load_si256((const __m256i *)lanes->s0);
+	__m256i s1 = _mm256_load_si256((const __m256i *)lanes->s1);
+	__m256i s2 = _mm256_load_si256((const __m256i *)lanes->s2);
+	__m256i s3 = _mm256_load_si256((const __m256i *)lanes->s3);
+	__m256 base = _mm256_set1_ps(min);
+	__m256 step = _mm256_set1_ps(scale);
+	for (; i < count; i += RNG_LANES)
+	{
+		__m256i result = _mm256_add_epi32(s0, s3);
+		__m256i t = _mm256_slli_epi32(s1, 9);
+		s2 = _mm256_xor_si256(s2, s0);
+		s3 = _mm256_xor_si256(s3, s1);
+		s1 = _mm256_xor_si256(s1, s2);
+		s0 = _mm256_xor_si256(s0, s3);
+		s2 = _mm256_xor_si256(s2, t);
+		s3 = _mm256_or_si256(_mm256_slli_epi32(s3, 11), _mm256_srli_epi32(s3, 21));
+		__m256 value = _mm256_add_ps(base, _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_srli_epi32(result, 8)), step));
+		if (count - i >= RNG_LANES)
+		{
+			_mm256_storeu_ps(out + i, value);
+		}
+		else
+		{
+			_mm256_store_ps(tail, value);
+			memcpy(out + i, tail, sizeof(float) * (count - i));
+		}
+	}
+	_mm256_store_si256((__m256i *)lanes->s0, s0);
+	_mm256_store_si256((__m256i *)lanes->s1, s1);
+	_mm256_store_si256((__m256i *)lanes->s2, s2);
+	_mm256_store_si256((__m256i *)lanes->s3, s3);
+#elif defined(__SSE2__) || defined(_M_X64)
+	// two independent halves of four lanes
+	__m128 base = _mm_set1_ps(min);
+	__m128 step = _mm_set1_ps(scale);
+	for (int half = 0; half < RNG_LANES; half += 4)
+	{
+		__m128i s0 = _mm_load_si128((const __m128i *)(lanes->s0 + half));
+		__m128i s1 = _mm_load_si128((const __m128i *)(lanes->s1 + half));
+		__m128i s2 = _mm_load_si128((const __m128i *)(lanes->s2 + half));
+		__m128i s3 = _mm_load_si128((const __m128i *)(lanes->s3 + half));
+		for (i = 0; i < count; i += RNG_LANES)
+		{
+			__m128i result = _mm_add_epi32(s0, s3);
+			__m128i t = _mm_slli_epi32(s1, 9);
+			s2 = _mm_xor_si128(s2, s0);
+			s3 = _mm_xor_si128(s3, s1);
+			s1 = _mm_xor_si128(s1, s2);
+			s0 = _mm_xor_si128(s0, s3);
+			s2 = _mm_xor_si128(s2, t);
+			s3 = _mm_or_si128(_mm_slli_epi32(s3, 11), _mm_srli_epi32(s3, 21));
+			__m128 value = _mm_add_ps(base, _mm_mul_ps(_mm_cvtepi32_ps(_mm_srli_epi32(result, 8)), step));
+			if (count - i >= RNG_LANES)
+			{
+				_mm_storeu_ps(out + i + half, value);
+			}
+			else
+			{
+				_mm_store_ps(tail, value);
+				for (int lane = 0; lane < 4 && i + half + lane < count; lane++)
+				{
+					out[i + half + lane] = tail[lane];
+				}
+			}
+		}
+		_mm_store_si128((__m128i *)(lanes->s0 + half), s0);
+		_mm_store_si128((__m128i *)(lanes->s1 + half), s1);
+		_mm_store_si128((__m128i *)(lanes->s2 + half), s2);
+		_mm_store_si128((__m128i *)(lanes->s3 + half), s3);
+	}
+#else
+	for (; i < count; i += RNG_LANES)
+	{
+		for (int lane = 0; lane < RNG_LANES; lane++)
+		{
+			tail[lane] = stepLane(lanes, lane, min, scale);
+		}
+		int32_t take = (count - i < RNG_LANES) ? count - i : RNG_LANES;
+		memcpy(out + i, tail, sizeof(float) * take);
+	}
+#endif
+}
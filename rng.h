@@ -0,0 +1,42 @@
+#ifndef RNG_H
+#define RNG_H
+
+#include <stdint.h>
+
+// Small, seedable random streams with no global state. Each system keeps its
+// own Rng in the game state, so its draws depend only on the run's seed and
+// its own history: reproducible on every platform, and safe to use from
+// whichever worker runs that system.
+//
+// Rng is PCG32 (64-bit state, one 32-bit draw per step) for the odd draw
+// here and there. RngLanes is eight interleaved xoshiro128+ generators laid
+// out as arrays, so bulk fills step all eight with one set of vector ops.
+
+#define RNG_LANES 8
+
+typedef struct Rng
+{
+	uint64_t state;
+	// odd; picks one of 2^63 independent sequences for the same seed
+	uint64_t increment;
+} Rng;
+
+typedef struct RngLanes
+{
+	_Alignas(32) uint32_t s0[RNG_LANES];
+	uint32_t s1[RNG_LANES];
+	uint32_t s2[RNG_LANES];
+	uint32_t s3[RNG_LANES];
+} RngLanes;
+
+//functions==================
+//
+void seedRng(Rng *rng, uint64_t seed, uint64_t stream);
+uint32_t nextRandom(Rng *rng);
+float randomUnit(Rng *rng);
+void seedRngLanes(RngLanes *lanes, Rng *source);
+void fillRandomFloats(RngLanes *lanes, float *out, int32_t count, float min, float max);
+//
+//===========================
+
+#endif
@@ -0,0 +1,62 @@
+#include "shapes.h"
+
+#define SCALED(x, y, scale) { (x) * (scale), (y) * (scale) }
+
+static const Vector2 playerShapePoints[] = {
+	SCALED(0.0f, 0.0f, PLAYER_SCALE),
+	SCALED(0.0f, -1.0f, PLAYER_SCALE),
+	SCALED(-0.5f, 0.0f, PLAYER_SCALE),
+	SCALED(-0.25f, 0.25f, PLAYER_SCALE),
+	SCALED(0.0f, 0.0f, PLAYER_SCALE),
+	SCALED(0.25f, 0.25f, PLAYER_SCALE),
+	SCALED(0.5f, 0.0f, PLAYER_SCALE),
+	SCALED(0.0f, -1.0f, PLAYER_SCALE),
+};
+
+static const Vector2 alienShapePoints[] = {
+	SCALED(0.0f, 0.0f, ALIEN_SCALE),
+	SCALED(0.0f, -1.0f, ALIEN_SCALE),
+	SCALED(-0.5f, -0.5f, ALIEN_SCALE),
+	SCALED(-1.0f, 0.0f, ALIEN_SCALE),
+	SCALED(-0.5f, 0.25f, ALIEN_SCALE),
+	SCALED(0.0f, 0.25f, ALIEN_SCALE),
+	SCALED(-0.25f, 0.25f, ALIEN_SCALE),
+	SCALED(0.0f, 1.0f, ALIEN_SCALE),
+	SCALED(0.25f, 0.25f, ALIEN_SCALE),
+	SCALED(0.0f, 0.25f, ALIEN_SCALE),
+	SCALED(0.5f, 0.25f, ALIEN_SCALE),
+	SCALED(1.0f, 0.0f, ALIEN_SCALE),
+	SCALED(0.5f, -0.5f, ALIEN_SCALE),
+	SCALED(0.0f, -1.0f, ALIEN_SCALE),
+};
+
+static const Vector2 bossShapePoints[] = {
+	SCALED(0.0f, 0.0f, BOSS_SCALE),
+	SCALED(1.0f, 0.0f, BOSS_SCALE),
+	SCALED(1.0f, 1.0f, BOSS_SCALE),
+	SCALED(0.0f, 1.0f, BOSS_SCALE),
+	SCALED(-1.0f, 1.0f, BOSS_SCALE),
+	SCALED(-1.0f, 0.0f, BOSS_SCALE),
+	SCALED(0.0f, -1.0f, BOSS_SCALE),
+	SCALED(1.0f, -1.0f, BOSS_SCALE),
+};
+
+const Shape enemyShapes[EnemyTypeCount] = {
+	[Alien] = {
+		alienShapePoints,
+		sizeof(alienShapePoints) / sizeof(alienShapePoints[0]),
+		{ ENEMY_COLLIDER_SIZE, ENEMY_COLLIDER_SIZE },
+	},
+	[Boss] = {
+		bossShapePoints,
+		sizeof(bossShapePoints) / sizeof(bossShapePoints[0]),
+		{ ENEMY_COLLIDER_SIZE, ENEMY_COLLIDER_SIZE },
+	},
+};
+
+// collider size is unused, the player keeps its own collider
+const Shape playerShape = {
+	playerShapePoints,
+	sizeof(playerShapePoints) / sizeof(playerShapePoints[0]),
+	{ 0.0f, 0.0f },
+};
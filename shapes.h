@@ -0,0 +1,32 @@
+#ifndef SHAPES_H
+#define SHAPES_H
+
+#include "raylib.h"
+#include <stdint.h>
+
+#define PLAYER_SCALE 25.0f
+#define ALIEN_SCALE 22.0f
+#define BOSS_SCALE 50.0f
+#define ENEMY_COLLIDER_SIZE 50.0f
+
+typedef enum
+{
+	Alien,
+	Boss,
+	EnemyTypeCount
+} EnemyType ;
+
+// Immutable outline, already scaled to world units and centred on the
+// owner's position, with points[0] as the triangle fan centre. Built at
+// compile time and shared by everything drawn with it.
+typedef struct Shape
+{
+	const Vector2 *points;
+	int32_t pointCount;
+	Vector2 colliderSize;
+} Shape;
+
+extern const Shape enemyShapes[EnemyTypeCount];
+extern const Shape playerShape;
+
+#endif
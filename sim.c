@@ -0,0 +1,665 @@
+#include "sim.h"
+#include "logger.h"
+#include <math.h>
+#include <stdio.h>
+
+SimConfig defaultSimConfig(void)
+{
+	SimConfig config = {0};
+	config.bulletCapacity = PLAYER_BULLETS;
+	config.waveCount = 1;
+	config.enemyCount = ENEMEY_NUMBER;
+	config.seed = 1;
+	return config;
+}
+
+// Every count positive and the enemies over all waves within SIM_MAX_ENEMIES.
+bool validSimConfig(const SimConfig *config)
+{
+	int64_t enemies = (int64_t)config->waveCount * config->enemyCount;
+	return config->bulletCapacity > 0 && config->bulletCapacity <= SIM_MAX_BULLETS
+		&& config->waveCount > 0 && config->enemyCount > 0 && enemies <= SIM_MAX_ENEMIES;
+}
+
+// Upper bound on what initState pushes on the permanent arena for a valid
+// config, alignment padding included.
+size_t stateBytes(const SimConfig *config)
+{
+	size_t bullets = ((size_t)config->bulletCapacity + BULLET_POOL_LANES - 1) & ~(size_t)(BULLET_POOL_LANES - 1);
+	size_t enemies = (size_t)config->waveCount * (size_t)config->enemyCount;
+	return sizeof(State) + sizeof(Player) + 4 * bullets * sizeof(float)
+		+ (size_t)config->waveCount * sizeof(EnemyWave) + enemies * sizeof(Enemy) + 8 * 32;
+}
+
+// Returns NULL, leaving the memory uninitialised, for a config that is not
+// valid or when the blocks are too small for it.
+State *initState(GameMemory *game, const SimConfig *config)
+{
+	State *state = (State *)game->PermanantStorage;
+	if (!game->IsInitialised)
+	{
+		if (!validSimConfig(config))
+		{
+			return NULL;
+		}
+		MemoryArena bootstrap;
+		initArena(&bootstrap, "permanent", game->PermanantStorage, game->PermanantStorageSize);
+		state = PushStruct(&bootstrap, State);
+		if (!state || !initTransientState(game))
+		{
+			return NULL;
+		}
+		// arenas hold their base relative to themselves, so the permanent one
+		// is set up again where it lives before anything else is pushed
+		MemoryArena *permanent = &state->permanentArena;
+		initArena(permanent, "permanent", game->PermanantStorage, game->PermanantStorageSize);
+		permanent->used = bootstrap.used;
+		permanent->highWater = bootstrap.highWater;
+
+		Player *player = PushStruct(permanent, Player);
+		if (!player || !initBulletPool(&state->playerBullets, permanent, config->bulletCapacity))
+		{
+			return NULL;
+		}
+
+		float shipHeight = (PLAYER_BASE_LEN/2.0) / tanf(20*DEG2RAD);
+		player->height = shipHeight;
+		player->position = (Vector2){SCREENWIGTH/2.0, SCREENHEIGTH - shipHeight};
+		player->previousPosition = player->position;
+		player->speed = PlAYER_SPEED;
+		player->collider = (Rectangle){
+			player->position.x - (PLAYER_BASE_LEN/2.0),
+			player->position.y - shipHeight,
+			PLAYER_BASE_LEN,
+			shipHeight
+		};
+
+		//state-data
+		relPtrSet(&state->player, player);
+		state->state = GAME;
+
+		state->waveCount = config->waveCount;
+		state->enemyCount = (int32_t)((int64_t)config->waveCount * config->enemyCount);
+		EnemyWave *waves = PushArray(permanent, state->waveCount, EnemyWave);
+		Enemy *enemies = PushArray(permanent, state->enemyCount, Enemy);
+		if (!waves || !enemies)
+		{
+			return NULL;
+		}
+		relPtrSet(&state->waves, waves);
+		relPtrSet(&state->enemies, enemies);
+		for (int32_t i = 0; i < state->waveCount; i++)
+		{
+			// extra waves start a row further down each, wrapping like rows do
+			Vector2 origin = { 100.0f, 50.0f + (i % ENEMY_WAVE_ROWS) * ENEMY_SPACING };
+			initEnemyWave(&waves[i], enemies, i * config->enemyCount, config->enemyCount,
+				origin, config->seed, WAVE_RNG_STREAM + (uint64_t)i);
+		}
+		// everything the game keeps is in permanent from here on, so a state
+		// snapshot is its used bytes
+
+		game->IsInitialised = true;
+	}
+	return state;
+}
+
+// Sets up the transient block from scratch, the same way initState does the
+// permanent one. For initState, and for a snapshot loaded into memory that
+// was never initialised. NULL when the block cannot hold the frame arena.
+TransientState *initTransientState(GameMemory *game)
+{
+	MemoryArena bootstrap;
+	initArena(&bootstrap, "transient", game->TransientStorage, game->TransientStorageSize);
+	TransientState *transient = PushStruct(&bootstrap, TransientState);
+	if (!transient)
+	{
+		return NULL;
+	}
+	MemoryArena *arena = &transient->transientArena;
+	initArena(arena, "transient", game->TransientStorage, game->TransientStorageSize);
+	arena->used = bootstrap.used;
+	arena->highWater = bootstrap.highWater;
+	subArena(&transient->frameArena, arena, "frame", FRAME_ARENA_SIZE);
+	return arenaBase(&transient->frameArena) ? transient : NULL;
+}
+
+TransientState *transientState(const GameMemory *game)
+{
+	return (TransientState *)game->TransientStorage;
+}
+
+Player *statePlayer(const State *state)
+{
+	return RelPtrGet(state->player, Player);
+}
+
+EnemyWave *stateWaves(const State *state)
+{
+	return RelPtrGet(state->waves, EnemyWave);
+}
+
+Enemy *stateEnemies(const State *state)
+{
+	return RelPtrGet(state->enemies, Enemy);
+}
+
+Enemy *waveEnemies(const State *state, const EnemyWave *wave)
+{
+	return stateEnemies(state) + wave->firstEnemy;
+}
+
+// Called at the top of every loop iteration; everything pushed on the frame
+// arena during the previous iteration is gone after this.
+void beginFrameScratch(GameMemory *memory)
+{
+	TransientState *transient = transientState(memory);
+	// the frame's peak, not what its rewinds left behind
+	size_t peak = transient->frameArena.resetHighWater;
+	transient->frameArenaLastFrame = peak;
+	if (peak > transient->frameArenaPeakFrame)
+	{
+		transient->frameArenaPeakFrame = peak;
+#ifdef ARENA_DEBUG
+		logMessage(LOG_LEVEL_DEBUG, LOG_CATEGORY_MEMORY, "frame arena: new per-frame peak %zu bytes", peak);
+#endif
+	}
+	arenaReset(&transient->frameArena);
+}
+
+static uint64_t hashBytes(uint64_t hash, const void *data, size_t size)
+{
+	const uint8_t *bytes = (const uint8_t *)data;
+	for (size_t i = 0; i < size; i++)
+	{
+		hash = (hash ^ bytes[i]) * 1099511628211ull;
+	}
+	return hash;
+}
+
+// FNV-1a over the gameplay state (not arenas or scratch), for checking that
+// two runs ended up in the same place.
+uint64_t hashState(const State *state)
+{
+	uint64_t hash = 14695981039346656037ull;
+	const Player *player = statePlayer(state);
+	hash = hashBytes(hash, &player->position, sizeof(player->position));
+	hash = hashBytes(hash, &player->collider, sizeof(player->collider));
+
+	const BulletPool *bullets = &state->playerBullets;
+	BulletArrays arrays = bulletArrays(bullets);
+	hash = hashBytes(hash, &bullets->count, sizeof(bullets->count));
+	hash = hashBytes(hash, arrays.x, sizeof(float) * bullets->count);
+	hash = hashBytes(hash, arrays.y, sizeof(float) * bullets->count);
+	hash = hashBytes(hash, arrays.vx, sizeof(float) * bullets->count);
+	hash = hashBytes(hash, arrays.vy, sizeof(float) * bullets->count);
+
+	const EnemyWave *waves = stateWaves(state);
+	for (int32_t i = 0; i < state->waveCount; i++)
+	{
+		const EnemyWave *wave = &waves[i];
+		hash = hashBytes(hash, &wave->wave_position, sizeof(wave->wave_position));
+		hash = hashBytes(hash, &wave->move_timer, sizeof(wave->move_timer));
+		hash = hashBytes(hash, &wave->is_moving, sizeof(wave->is_moving));
+		hash = hashBytes(hash, &wave->elapsed_time, sizeof(wave->elapsed_time));
+		// a pending tween shows up here before the wave moves
+		hash = hashBytes(hash, &wave->start_position, sizeof(wave->start_position));
+		hash = hashBytes(hash, &wave->target_position, sizeof(wave->target_position));
+		hash = hashBytes(hash, &wave->target_set, sizeof(wave->target_set));
+		hash = hashBytes(hash, &wave->rng, sizeof(wave->rng));
+	}
+	const Enemy *enemies = stateEnemies(state);
+	for (int32_t i = 0; i < state->enemyCount; i++)
+	{
+		const Enemy *enemy = &enemies[i];
+		hash = hashBytes(hash, &enemy->offset, sizeof(enemy->offset));
+		hash = hashBytes(hash, &enemy->type, sizeof(enemy->type));
+		hash = hashBytes(hash, &enemy->active, sizeof(enemy->active));
+	}
+	return hash;
+}
+
+void reportMemory(const GameMemory *memory)
+{
+	const State *state = (const State *)memory->PermanantStorage;
+	const TransientState *transient = transientState(memory);
+	reportArena(&state->permanentArena);
+	reportArena(&transient->transientArena);
+	reportArena(&transient->frameArena);
+	printf("frame arena per-frame peak %zu bytes, last frame %zu bytes\n",
+		transient->frameArenaPeakFrame, transient->frameArenaLastFrame);
+}
+
+// Advances the game by exactly dt seconds. Has no window, clock or input
+// device dependency so it can be driven by the windowed loop and the
+// headless runner alike.
+void SimStep(GameMemory *memory, const InputFrame *input, float dt)
+{
+	State *state = (State *)memory->PermanantStorage;
+	JobSystem *jobs = memory->jobs;
+	Profiler *profiler = memory->profiler;
+	beginProfilePhase(profiler, PROFILE_SIM_TICK);
+
+	beginProfilePhase(profiler, PROFILE_SIM_PLAYER);
+	movePlayer(state, input, dt);
+	if (input->buttons & INPUT_SHOOT)
+	{
+		shootBullet(state);
+	}
+	endProfilePhase(profiler, PROFILE_SIM_PLAYER);
+
+	beginProfilePhase(profiler, PROFILE_SIM_BULLETS);
+	updateBullets(state, jobs, dt);
+	endProfilePhase(profiler, PROFILE_SIM_BULLETS);
+
+	beginProfilePhase(profiler, PROFILE_SIM_WAVES);
+	updateEnemyWaves(state, jobs, dt);
+	endProfilePhase(profiler, PROFILE_SIM_WAVES);
+
+	beginProfilePhase(profiler, PROFILE_SIM_COLLISION);
+	resolveBulletHits(state, jobs, &transientState(memory)->frameArena, dt);
+	endProfilePhase(profiler, PROFILE_SIM_COLLISION);
+
+	// Check if bullet is out of screen, only once hits for the whole tick are in
+	beginProfilePhase(profiler, PROFILE_SIM_CULL);
+	cullBullets(&state->playerBullets, 0.0f);
+	endProfilePhase(profiler, PROFILE_SIM_CULL);
+
+	endProfilePhase(profiler, PROFILE_SIM_TICK);
+}
+
+void movePlayer(State *state, const InputFrame *input, float dt)
+{
+	Player *player = statePlayer(state);
+	player->previousPosition = player->position;
+	if ((input->buttons & INPUT_RIGHT)
+		&& player->position.x <= SCREENWIGTH - PLAYER_BASE_LEN)
+	{
+		player->position.x += player->speed * dt;
+	}
+	if ((input->buttons & INPUT_LEFT)
+		&& player->position.x >= 0 + PLAYER_BASE_LEN)
+	{
+		player->position.x -= player->speed * dt;
+	}
+	if ((input->buttons & INPUT_UP)
+		&& player->position.y >= 0 + player->height)
+	{
+		player->position.y -= player->speed * dt;
+	}
+	if ((input->buttons & INPUT_DOWN)
+		&& player->position.y <= SCREENHEIGTH - player->height)
+	{
+		player->position.y += player->speed * dt;
+	}
+
+	// Update collider position
+	player->collider.x = player->position.x - (PLAYER_BASE_LEN/2.0);
+	player->collider.y = player->position.y - player->height;
+}
+
+void shootBullet(State *state)
+{
+	const Player *player = statePlayer(state);
+	Vector2 position = { player->position.x, player->position.y - player->height };
+	spawnBullet(&state->playerBullets, position, (Vector2){ 0, -BULLET_SPEED }); // Bullets move up
+}
+
+typedef struct IntegrateBulletsJob
+{
+	BulletPool *pool;
+	float dt;
+} IntegrateBulletsJob;
+
+static void integrateBulletsJob(void *data, int32_t begin, int32_t end)
+{
+	IntegrateBulletsJob *job = (IntegrateBulletsJob *)data;
+	integrateBulletRange(job->pool, begin, end, job->dt);
+}
+
+void updateBullets(State *state, JobSystem *jobs, float dt)
+{
+	IntegrateBulletsJob job = { &state->playerBullets, dt };
+	JobCounter counter = {0};
+	parallelFor(jobs, integrateBulletsJob, &job, state->playerBullets.count, BULLET_JOB_GRAIN, &counter);
+	waitForJobs(jobs, &counter);
+}
+
+Enemy* initSingularEnemey(Enemy *enemy, int32_t type)
+{
+	if (type < 0 || type >= EnemyTypeCount)
+	{
+		return NULL; // Invalid enemy type
+	}
+
+	enemy->type = (uint8_t)type;
+	enemy->active = false;
+	enemy->offset = (Vector2){0.0f, 0.0f};
+
+	return enemy;
+}
+
+// Gives the wave enemies[firstEnemy, firstEnemy + count), lays them out in
+// rows from origin and leaves the wave resting.
+void initEnemyWave(EnemyWave *wave, Enemy *enemies, int32_t firstEnemy, int32_t count, Vector2 origin, uint32_t seed, uint64_t stream)
+{
+	wave->enemyType = Alien;
+	wave->enemy_number = count;
+	wave->firstEnemy = firstEnemy;
+	wave->wave_position = origin;
+	wave->previous_wave_position = origin;
+	wave->is_moving = false;
+	wave->move_timer = 0.0f;
+	wave->start_position = (Vector2){0.0f, 0.0f};
+	wave->target_position = (Vector2){0.0f, 0.0f};
+	wave->elapsed_time = 0.0f;
+	wave->target_set = false;
+	seedRng(&wave->rng, seed, stream);
+
+	for (int32_t i = 0; i < count; i++)
+	{
+		Enemy *enemy = initSingularEnemey(&enemies[firstEnemy + i], wave->enemyType);
+		enemy->offset = (Vector2){
+			(i % ENEMY_WAVE_COLUMNS) * ENEMY_SPACING,
+			((i / ENEMY_WAVE_COLUMNS) % ENEMY_WAVE_ROWS) * ENEMY_SPACING
+		};
+		enemy->active = true;
+	}
+}
+
+Vector2 enemyPosition(const EnemyWave *wave, const Enemy *enemy)
+{
+	return (Vector2){ wave->wave_position.x + enemy->offset.x, wave->wave_position.y + enemy->offset.y };
+}
+
+Rectangle enemyCollider(const EnemyWave *wave, const Enemy *enemy)
+{
+	Vector2 position = enemyPosition(wave, enemy);
+	Vector2 size = enemyShapes[enemy->type].colliderSize;
+	return (Rectangle){ position.x - size.x / 2, position.y - size.y / 2, size.x, size.y };
+}
+
+// Nearest wave x to x at which every live enemy keeps its centre on screen
+// and its collider inside the right edge. enemies is the wave's own slice.
+// Walks the wave, so it is only called when a new target is picked.
+float clampToFormation(const EnemyWave *wave, const Enemy *enemies, float x)
+{
+	float lowest = -1e30f;
+	float highest = 1e30f;
+	for (int32_t i = 0; i < wave->enemy_number; i++)
+	{
+		const Enemy *enemy = &enemies[i];
+		if (enemy->active)
+		{
+			float halfWidth = enemyShapes[enemy->type].colliderSize.x / 2;
+			lowest = fmaxf(lowest, -enemy->offset.x);
+			highest = fminf(highest, SCREENWIGTH - (enemy->offset.x + halfWidth));
+		}
+	}
+	if (x > highest)
+	{
+		x = highest;
+	}
+	// a formation wider than the screen stays pinned to the left edge
+	if (x < lowest)
+	{
+		x = lowest;
+	}
+	return x;
+}
+
+float random_float(Rng *rng, float min, float max)
+{
+	return randomUnit(rng) * (max - min) + min;
+}
+
+float easeInOut(float t)
+{
+	return -(cos(M_PI * t) - 1) / 2;
+}
+
+// Advances one wave's tween by dt. The target is clamped to the formation
+// when it is picked and the ease never overshoots, so the wave stays on
+// screen without checking its enemies every tick; this is O(1) per tick
+// whatever the wave's size. Writes nothing outside the wave; enemies is its
+// slice, only read when a target is picked.
+void enemyWaveRandomMovement(EnemyWave *wave, const Enemy *enemies, float dt)
+{
+	wave->previous_wave_position = wave->wave_position;
+	if (!wave->is_moving)
+	{
+		wave->move_timer += dt; // Update the timer
+
+		// Check if 5 seconds have passed
+		if (wave->move_timer >= 5.0f)
+		{
+		    wave->is_moving = true;
+		    wave->move_timer = 0.0f; // Reset the timer
+		    wave->start_position = wave->wave_position;
+
+			// the wave only moves sideways
+			wave->target_position.x = clampToFormation(wave, enemies, random_float(&wave->rng, -100.0, 100.0));
+			wave->target_position.y = wave->wave_position.y;
+			logMessage(LOG_LEVEL_DEBUG, LOG_CATEGORY_SIM, "wave at x %.1f heading for x %.1f",
+				wave->wave_position.x, wave->target_position.x);
+			wave->elapsed_time = 0.0f;
+			wave->target_set = true;
+		}
+	}
+
+	if (wave->is_moving && wave->target_set)
+	{
+		 wave->elapsed_time += dt;
+        float t = wave->elapsed_time / 1.0f; // Duration of 1 second for the ease-in-out movement
+        if (t >= 1.0f)
+        {
+            t = 1.0f;
+            wave->is_moving = false; // Stop moving after reaching the target
+            wave->target_set = false; // Reset the target flag
+        }
+	// Apply ease-in-out to the interpolation
+        float ease = easeInOut(t);
+        Vector2 new_wave_position = {
+            wave->start_position.x + (wave->target_position.x - wave->start_position.x) * ease,
+            wave->start_position.y + (wave->target_position.y - wave->start_position.y) * ease
+        };
+	logMessage(LOG_LEVEL_TRACE, LOG_CATEGORY_SIM, "vector x: %f, y:%f", wave->wave_position.x, wave->wave_position.y);
+	//wave->wave_position.y = random_float(20.0, 50.0);
+
+        wave->wave_position = new_wave_position;
+
+	}
+}
+
+typedef struct WaveTweenJob
+{
+	EnemyWave *waves;
+	const Enemy *enemies;
+	float dt;
+} WaveTweenJob;
+
+static void waveTweenJob(void *data, int32_t begin, int32_t end)
+{
+	WaveTweenJob *job = (WaveTweenJob *)data;
+	for (int32_t i = begin; i < end; i++)
+	{
+		EnemyWave *wave = &job->waves[i];
+		enemyWaveRandomMovement(wave, job->enemies + wave->firstEnemy, job->dt);
+	}
+}
+
+// Every wave's tween in one batched pass, fanned out over the job system by
+// wave. Enemies ride along through their offsets.
+void updateEnemyWaves(State *state, JobSystem *jobs, float dt)
+{
+	WaveTweenJob tween = { stateWaves(state), stateEnemies(state), dt };
+	JobCounter tweened = {0};
+	parallelFor(jobs, waveTweenJob, &tween, state->waveCount, WAVE_JOB_GRAIN, &tweened);
+	waitForJobs(jobs, &tweened);
+}
+
+typedef struct BulletQueryJob
+{
+	const CollisionGrid *grid;
+	const bool *alive;
+	const BulletPool *bullets;
+	SweepHit *hits;
+	float dt;
+} BulletQueryJob;
+
+// First enemy each bullet's sweep reaches with every enemy still alive.
+// Read-only on shared state, so bullets can be split across workers freely.
+static void bulletQueryJob(void *data, int32_t begin, int32_t end)
+{
+	BulletQueryJob *job = (BulletQueryJob *)data;
+	for (int32_t i = begin; i < end; i++)
+	{
+		job->hits[i] = gridFirstSweptHit(job->grid, job->alive,
+			bulletStartCollider(job->bullets, i, job->dt), bulletMotion(job->bullets, i, job->dt));
+	}
+}
+
+// Bullets against enemy colliders. Runs after integration and sweeps each
+// bullet's collider from where it started the tick to where it is now, so
+// fast bullets or coarse ticks cannot tunnel through an enemy; enemies are
+// taken at their end-of-tick position. Small sets are tested all-pairs,
+// larger ones bin the enemies into the grid once per tick and test each
+// bullet only against the cells its sweep touches. Either way a bullet takes
+// the enemy it reaches first, and a hit removes both.
+//
+// Out of frame scratch the tick resolves no hits rather than writing through
+// NULL; the log says so.
+static void scratchExhausted(ArenaMark mark)
+{
+	logMessage(LOG_LEVEL_ERROR, LOG_CATEGORY_MEMORY, "%s arena exhausted, bullet hits skipped this tick", mark.arena->name);
+	arenaRewind(mark);
+}
+
+// The grid queries fan out over the job system against the enemies alive at
+// the start of the tick; hits are then applied in bullet order, and a bullet
+// whose enemy an earlier bullet already took is queried again. An earliest
+// hit among all enemies that is still alive is also the earliest among the
+// survivors, so the result matches a serial pass exactly.
+void resolveBulletHits(State *state, JobSystem *jobs, MemoryArena *scratch, float dt)
+{
+	const EnemyWave *waves = stateWaves(state);
+	Enemy *enemies = stateEnemies(state);
+	BulletPool *bullets = &state->playerBullets;
+	if (bullets->count == 0)
+	{
+		return;
+	}
+
+	ArenaMark mark = arenaMark(scratch);
+	Rectangle *boxes = PushArray(scratch, state->enemyCount, Rectangle);
+	int32_t *owners = PushArray(scratch, state->enemyCount, int32_t);
+	bool *alive = PushArray(scratch, state->enemyCount, bool);
+	if (!boxes || !owners || !alive)
+	{
+		scratchExhausted(mark);
+		return;
+	}
+	int32_t boxCount = 0;
+	for (int32_t w = 0; w < state->waveCount; w++)
+	{
+		const EnemyWave *wave = &waves[w];
+		const Enemy *waveEnemy = enemies + wave->firstEnemy;
+		for (int32_t i = 0; i < wave->enemy_number; i++)
+		{
+			if (waveEnemy[i].active)
+			{
+				boxes[boxCount] = enemyCollider(wave, &waveEnemy[i]);
+				owners[boxCount] = wave->firstEnemy + i;
+				alive[boxCount] = true;
+				boxCount++;
+			}
+		}
+	}
+
+	if (boxCount > 0)
+	{
+		int32_t *hitBullets = PushArray(scratch, bullets->count, int32_t);
+		int32_t hitCount = 0;
+		if (!hitBullets)
+		{
+			scratchExhausted(mark);
+			return;
+		}
+
+		if ((int64_t)bullets->count * boxCount <= COLLISION_ALL_PAIRS_LIMIT)
+		{
+			ColliderSoA enemyBounds;
+			ColliderSoA bulletBounds;
+			int32_t words = overlapMaskWords(boxCount);
+			bool enemiesFit = initColliderSoA(&enemyBounds, scratch, boxCount);
+			bool bulletsFit = initColliderSoA(&bulletBounds, scratch, bullets->count);
+			uint32_t *masks = PushArray(scratch, (size_t)bullets->count * words, uint32_t);
+			if (!enemiesFit || !bulletsFit || !masks)
+			{
+				scratchExhausted(mark);
+				return;
+			}
+			for (int32_t i = 0; i < boxCount; i++)
+			{
+				setCollider(&enemyBounds, i, boxes[i]);
+			}
+			for (int32_t i = 0; i < bullets->count; i++)
+			{
+				setCollider(&bulletBounds, i, sweptBounds(bulletStartCollider(bullets, i, dt), bulletMotion(bullets, i, dt)));
+			}
+
+			aabbOverlapAllPairs(&bulletBounds, &enemyBounds, masks);
+			for (int32_t i = 0; i < bullets->count; i++)
+			{
+				SweepHit hit = firstSweptHit(masks + (size_t)i * words, words, alive, &enemyBounds,
+					bulletStartCollider(bullets, i, dt), bulletMotion(bullets, i, dt));
+				if (hit.item >= 0)
+				{
+					alive[hit.item] = false;
+					enemies[owners[hit.item]].active = false;
+					hitBullets[hitCount++] = i;
+				}
+			}
+		}
+		else
+		{
+			// per-tick scratch on the frame arena, so not part of State
+			CollisionGrid grid;
+			initCollisionGrid(&grid, SCREENWIGTH, SCREENHEIGTH, COLLISION_CELL_SIZE);
+			bool gridFits = buildCollisionGrid(&grid, scratch, boxes, boxCount);
+			SweepHit *hits = PushArray(scratch, bullets->count, SweepHit);
+			if (!gridFits || !hits)
+			{
+				scratchExhausted(mark);
+				return;
+			}
+			BulletQueryJob query = { &grid, alive, bullets, hits, dt };
+			JobCounter counter = {0};
+			parallelFor(jobs, bulletQueryJob, &query, bullets->count, COLLISION_JOB_GRAIN, &counter);
+			waitForJobs(jobs, &counter);
+
+			for (int32_t i = 0; i < bullets->count; i++)
+			{
+				SweepHit hit = hits[i];
+				if (hit.item >= 0 && !alive[hit.item])
+				{
+					hit = gridFirstSweptHit(&grid, alive,
+						bulletStartCollider(bullets, i, dt), bulletMotion(bullets, i, dt));
+				}
+				if (hit.item >= 0)
+				{
+					alive[hit.item] = false;
+					enemies[owners[hit.item]].active = false;
+					hitBullets[hitCount++] = i;
+				}
+			}
+		}
+
+		// highest index first so swap-remove never moves a bullet still to go
+		while (hitCount > 0)
+		{
+			despawnBullet(bullets, hitBullets[--hitCount]);
+		}
+	}
+
+	arenaRewind(mark);
+}
@@ -0,0 +1,223 @@
+#ifndef SIM_H
+#define SIM_H
+
+// raylib.h is only pulled in for its plain data types (Vector2, Rectangle),
+// nothing in the simulation calls into raylib.
+#include "raylib.h"
+#include "arena.h"
+#include "bullets.h"
+#include "collision.h"
+#include "jobs.h"
+#include "logger.h"
+#include "profiler.h"
+#include "rng.h"
+#include "shapes.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define SCREENWIGTH 640
+#define SCREENHEIGTH 320
+
+#define PLAYER_BASE_LEN 20
+#define PlAYER_SPEED 200.0
+#define PLAYER_OFFSET_BOTTOM 20.0
+#define PLAYER_BULLETS 50
+#define ENEMEY_NUMBER 5
+// larger waves fill rows of this many, stacking again past the last row
+#define ENEMY_WAVE_COLUMNS 10
+#define ENEMY_WAVE_ROWS 4
+#define ENEMY_SPACING 50.0f
+
+// items per job when a system fans out over the job system; bullet ranges
+// must stay a multiple of BULLET_POOL_LANES
+#define BULLET_JOB_GRAIN 4096
+#define WAVE_JOB_GRAIN 64
+#define COLLISION_JOB_GRAIN 256
+
+#define FRAME_ARENA_SIZE Megabytes(32)
+
+// Rng stream per system, so each draws an unrelated sequence from the seed;
+// wave i draws from WAVE_RNG_STREAM + i
+#define WAVE_RNG_STREAM 1
+
+#define SIM_HZ 120
+#define SIM_DT (1.0f / SIM_HZ)
+
+// SimConfig limits, low enough that no count or size derived from them
+// overflows an int32
+#define SIM_MAX_BULLETS (1 << 24)
+#define SIM_MAX_ENEMIES (1 << 24)
+
+// what the hosts reserve for GameMemory
+#define PERMANENT_STORAGE_SIZE Megabytes(64)
+#define TRANSIENT_STORAGE_SIZE Megabytes(128)
+
+#ifndef M_PI
+#    define M_PI 3.14159265358979323846
+#endif
+
+typedef struct GameMemory
+{
+	size_t PermanantStorageSize;
+	void *PermanantStorage;
+
+	size_t TransientStorageSize;
+	void *TransientStorage;
+
+	bool IsInitialised;
+	// the host's; a freshly loaded game module has no logger of its own
+	Logger *logger;
+	// the host's; NULL runs every system serially
+	JobSystem *jobs;
+	// owned by the thread running the game; NULL skips phase timing
+	Profiler *profiler;
+} GameMemory;
+
+typedef struct Player
+{
+	Vector2 position;
+	Vector2 previousPosition;
+	float speed;
+	// derived from PLAYER_BASE_LEN at init
+	float height;
+	Rectangle collider;
+} Player;
+
+// Outline and collider size come from enemyShapes[type]; the collider is
+// centred on the enemy. offset is from the wave's wave_position, so moving a
+// wave moves every enemy in it without touching them; enemyPosition() gives
+// the world position when something needs it.
+typedef struct Enemy
+{
+	Vector2 offset;
+	uint8_t type;
+	bool active;
+} Enemy;
+
+// A formation that moves as one. Every few seconds it eases its x to a
+// random target over one second, picked so every live enemy stays on
+// screen; the tween lives here so each wave moves on its own and all of
+// them can be stepped in one pass.
+typedef struct EnemeyWave
+{
+	int32_t enemy_number;
+	Vector2 wave_position;
+	Vector2 previous_wave_position;
+	// its enemies are State.enemies[firstEnemy, firstEnemy + enemy_number)
+	int32_t firstEnemy;
+	int32_t enemyType;
+	bool is_moving;
+	float move_timer;
+
+	Vector2 start_position;
+	Vector2 target_position;
+	float elapsed_time;
+	bool target_set;
+	Rng rng;
+} EnemyWave;
+
+typedef enum
+{
+	GAME,
+	MAIN,
+	PAUSE
+} StateType;
+
+// Lives at the very start of PermanantStorage, followed by everything else
+// the game keeps between ticks, so the permanent arena's used bytes are the
+// whole game state (see snapshot.h).
+//
+// Nothing in it holds an address: references into the block are RelPtrs
+// (statePlayer() and friends resolve them) or indices, and the host's
+// services live in GameMemory. The block means the same wherever it is
+// mapped, and two runs at the same tick are byte-for-byte equal.
+typedef struct State
+{
+	MemoryArena permanentArena;
+
+	StateType state;
+	// Player
+	RelPtr player;
+	BulletPool playerBullets;
+	// EnemyWave[waveCount]
+	RelPtr waves;
+	int32_t waveCount;
+	// Enemy[enemyCount], every wave's enemies back to back, wave by wave
+	RelPtr enemies;
+	int32_t enemyCount;
+} State;
+
+// Lives at the very start of TransientStorage: this process's scratch and
+// the buffers the host carves for itself. Not game state; a snapshot
+// restore leaves it alone.
+typedef struct TransientState
+{
+	MemoryArena transientArena;
+	// per-frame temporaries, carved from transient and reset every loop iteration
+	MemoryArena frameArena;
+	size_t frameArenaLastFrame;
+	size_t frameArenaPeakFrame;
+} TransientState;
+
+// Sizing knobs for a run; the windowed game uses defaultSimConfig(), the
+// headless runner scales them up for soak and stress runs.
+typedef struct SimConfig
+{
+	int32_t bulletCapacity;
+	int32_t waveCount;
+	// per wave
+	int32_t enemyCount;
+	// everything random in a run follows from this
+	uint32_t seed;
+} SimConfig;
+
+// one tick worth of player intent, sampled by the platform layer
+typedef enum
+{
+	INPUT_LEFT  = 1 << 0,
+	INPUT_RIGHT = 1 << 1,
+	INPUT_UP    = 1 << 2,
+	INPUT_DOWN  = 1 << 3,
+	INPUT_SHOOT = 1 << 4,
+} InputButton;
+
+typedef struct InputFrame
+{
+	uint8_t buttons;
+} InputFrame;
+
+//functions==================
+//
+SimConfig defaultSimConfig(void);
+bool validSimConfig(const SimConfig *config);
+size_t stateBytes(const SimConfig *config);
+State *initState(GameMemory *game, const SimConfig *config);
+TransientState *initTransientState(GameMemory *game);
+TransientState *transientState(const GameMemory *game);
+Player *statePlayer(const State *state);
+EnemyWave *stateWaves(const State *state);
+Enemy *stateEnemies(const State *state);
+Enemy *waveEnemies(const State *state, const EnemyWave *wave);
+void SimStep(GameMemory *memory, const InputFrame *input, float dt);
+void movePlayer(State *state, const InputFrame *input, float dt);
+void shootBullet(State *state);
+void updateBullets(State *state, JobSystem *jobs, float dt);
+Enemy* initSingularEnemey(Enemy *enemy, int32_t type);
+void initEnemyWave(EnemyWave *wave, Enemy *enemies, int32_t firstEnemy, int32_t count, Vector2 origin, uint32_t seed, uint64_t stream);
+Vector2 enemyPosition(const EnemyWave *wave, const Enemy *enemy);
+Rectangle enemyCollider(const EnemyWave *wave, const Enemy *enemy);
+float clampToFormation(const EnemyWave *wave, const Enemy *enemies, float x);
+void enemyWaveRandomMovement(EnemyWave *wave, const Enemy *enemies, float dt);
+void updateEnemyWaves(State *state, JobSystem *jobs, float dt);
+void resolveBulletHits(State *state, JobSystem *jobs, MemoryArena *scratch, float dt);
+
+float random_float(Rng *rng, float min, float max);
+float easeInOut(float t);
+uint64_t hashState(const State *state);
+void beginFrameScratch(GameMemory *memory);
+void reportMemory(const GameMemory *memory);
+//
+//===========================
+
+#endif
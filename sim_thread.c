@@ -0,0 +1,249 @@
+#include "sim_thread.h"
+#include <string.h>
+
+// Snapshot buffers come from the transient arena, so this must run before
+// the thread starts and before anyone else carves from it concurrently.
+// False when the arena cannot hold them.
+bool initSimThread(SimThread *sim, GameMemory *memory, State *state, bool showColliders)
+{
+	sim->memory = memory;
+	sim->state = state;
+	TransientState *transient = transientState(memory);
+	int32_t capacity = renderCommandCapacity(state);
+	for (int i = 0; i < 3; i++)
+	{
+		if (!initRenderCommandBuffer(&sim->snapshots[i].commands, &transient->transientArena, capacity))
+		{
+			return false;
+		}
+		sim->snapshots[i].tick = 0;
+		sim->snapshots[i].publishTime = 0.0;
+		sim->snapshots[i].tickTimingCount = 0;
+		sim->snapshots[i].recordTimingCount = 0;
+	}
+	initTripleBuffer(&sim->exchange);
+	atomic_init(&sim->heldButtons, 0u);
+	atomic_init(&sim->pressedButtons, 0u);
+	atomic_init(&sim->showColliders, showColliders);
+	atomic_init(&sim->quit, false);
+	sim->recorder = NULL;
+	sim->code = NULL;
+	sim->history = NULL;
+	sim->statePath = NULL;
+	atomic_init(&sim->rewindSteps, 0);
+	atomic_init(&sim->saveStateRequested, false);
+	atomic_init(&sim->loadStateRequested, false);
+	sim->running = false;
+	initProfiler(&sim->profiler);
+	memory->profiler = &sim->profiler;
+
+	// the reader starts on a valid picture of the initial state
+	FrameSnapshot *front = &sim->snapshots[sim->exchange.front];
+	recordRenderCommands(state, &front->commands, showColliders, SIM_DT);
+	sortRenderCommands(&front->commands, &transient->frameArena);
+	front->publishTime = platformGetSeconds();
+	return true;
+}
+
+// The game recorded the back snapshot's commands on the batch's last tick.
+// A slot that comes back unread keeps its timings and the next batch adds
+// to them, so every tick reaches the render thread's profiler.
+static void publishSnapshot(SimThread *sim, int64_t tick)
+{
+	FrameSnapshot *back = &sim->snapshots[sim->exchange.back];
+	if (back->recordTimingCount < SNAPSHOT_TICK_TIMINGS)
+	{
+		back->recordTimings[back->recordTimingCount++] = sim->profiler.last[PROFILE_SIM_RECORD];
+	}
+	back->tick = tick;
+	back->publishTime = platformGetSeconds();
+	if (!publishTripleBuffer(&sim->exchange))
+	{
+		FrameSnapshot *next = &sim->snapshots[sim->exchange.back];
+		next->tickTimingCount = 0;
+		next->recordTimingCount = 0;
+	}
+}
+
+// A restored state no longer follows from the recorded input, so the
+// recording is closed out with the hash of the state it had reached.
+static void stopRecordingForRestore(SimThread *sim, int64_t tick, uint64_t hashBeforeRestore)
+{
+	if (sim->recorder)
+	{
+		closeReplayWriter(sim->recorder, hashBeforeRestore);
+		sim->recorder = NULL;
+		logMessage(LOG_LEVEL_WARNING, LOG_CATEGORY_REPLAY, "state restored, replay recording stopped at tick %lld", (long long)tick);
+	}
+}
+
+// Save state, load state and rewind, between two ticks. Returns the tick
+// the sim continues from.
+static int64_t handleStateRequests(SimThread *sim, int64_t tick)
+{
+	if (atomic_exchange(&sim->saveStateRequested, false) && sim->statePath)
+	{
+		if (writeSnapshotFile(sim->memory, tick, sim->statePath))
+		{
+			logMessage(LOG_LEVEL_INFO, LOG_CATEGORY_SIM, "saved state at tick %lld to %s", (long long)tick, sim->statePath);
+		}
+		else
+		{
+			logMessage(LOG_LEVEL_WARNING, LOG_CATEGORY_SIM, "could not save state to %s", sim->statePath);
+		}
+	}
+
+	if (atomic_exchange(&sim->loadStateRequested, false) && sim->statePath)
+	{
+		int64_t restoredTick = tick;
+		uint64_t hash = sim->recorder ? hashState(sim->state) : 0;
+		double start = platformGetSeconds();
+		if (readSnapshotFile(sim->memory, sim->statePath, &restoredTick))
+		{
+			stopRecordingForRestore(sim, tick, hash);
+			tick = restoredTick;
+			logMessage(LOG_LEVEL_INFO, LOG_CATEGORY_SIM, "loaded state at tick %lld from %s in %.3f ms",
+				(long long)tick, sim->statePath, (platformGetSeconds() - start) * 1000.0);
+		}
+		else
+		{
+			logMessage(LOG_LEVEL_WARNING, LOG_CATEGORY_SIM, "could not load state from %s", sim->statePath);
+		}
+	}
+
+	int32_t steps = atomic_exchange(&sim->rewindSteps, 0);
+	if (steps > 0 && sim->history)
+	{
+		int64_t restoredTick = tick;
+		uint64_t hash = sim->recorder ? hashState(sim->state) : 0;
+		double start = platformGetSeconds();
+		if (rewindSnapshot(sim->history, sim->memory, steps, &restoredTick))
+		{
+			stopRecordingForRestore(sim, tick, hash);
+			tick = restoredTick;
+			logMessage(LOG_LEVEL_DEBUG, LOG_CATEGORY_SIM, "rewound to tick %lld in %.3f ms",
+				(long long)tick, (platformGetSeconds() - start) * 1000.0);
+		}
+	}
+	return tick;
+}
+
+static int simThreadProc(void *data)
+{
+	SimThread *sim = (SimThread *)data;
+	int64_t tick = 0;
+	double accumulator = 0.0;
+	double last = platformGetSeconds();
+
+	while (!atomic_load(&sim->quit))
+	{
+		// between two ticks, so nothing is running module code or touching
+		// the state
+		tick = handleStateRequests(sim, tick);
+		if (sim->code)
+		{
+			reloadGameCodeIfChanged(sim->code);
+		}
+		GameUpdateAndRenderFn *updateAndRender = sim->code ? sim->code->updateAndRender : GameUpdateAndRender;
+
+		double now = platformGetSeconds();
+		double elapsed = now - last;
+		last = now;
+		accumulator += (elapsed > SIM_MAX_CATCH_UP) ? SIM_MAX_CATCH_UP : elapsed;
+
+		bool stepped = false;
+		FrameSnapshot *back = &sim->snapshots[sim->exchange.back];
+		while (accumulator >= SIM_DT)
+		{
+			beginFrameScratch(sim->memory);
+
+			GameInput input = {0};
+			input.frame.buttons = (uint8_t)(atomic_load(&sim->heldButtons) | atomic_exchange(&sim->pressedButtons, 0u));
+			input.dt = SIM_DT;
+			if (accumulator - SIM_DT < SIM_DT)
+			{
+				// last tick of the batch draws the snapshot
+				input.commands = &back->commands;
+				input.showColliders = atomic_load(&sim->showColliders);
+			}
+			if (sim->recorder)
+			{
+				recordReplayInput(sim->recorder, &input.frame);
+			}
+			updateAndRender(sim->memory, &input);
+			if (back->tickTimingCount < SNAPSHOT_TICK_TIMINGS)
+			{
+				memcpy(back->tickTimings[back->tickTimingCount++], sim->profiler.last, sizeof(back->tickTimings[0]));
+			}
+			tick++;
+			if (sim->history && tick % SIM_HISTORY_INTERVAL == 0)
+			{
+				pushSnapshot(sim->history, sim->memory, tick);
+			}
+			accumulator -= SIM_DT;
+			stepped = true;
+		}
+
+		if (stepped)
+		{
+			publishSnapshot(sim, tick);
+		}
+		platformSleepSeconds(SIM_DT - accumulator);
+	}
+	return 0;
+}
+
+bool startSimThread(SimThread *sim)
+{
+	atomic_store(&sim->quit, false);
+	sim->running = platformStartThread(&sim->thread, simThreadProc, sim);
+	return sim->running;
+}
+
+// Returns once the sim thread has finished its current tick and exited; the
+// state is safe to read from the caller afterwards.
+void stopSimThread(SimThread *sim)
+{
+	if (sim->running)
+	{
+		atomic_store(&sim->quit, true);
+		platformJoinThread(&sim->thread);
+		sim->running = false;
+	}
+}
+
+// held buttons replace the previous sample, pressed ones accumulate until a
+// tick picks them up so a quick tap between ticks is never lost.
+void submitSimInput(SimThread *sim, const InputFrame *held, const InputFrame *pressed)
+{
+	atomic_store(&sim->heldButtons, held->buttons);
+	if (pressed->buttons)
+	{
+		atomic_fetch_or(&sim->pressedButtons, pressed->buttons);
+	}
+}
+
+// Steps are SIM_HISTORY_INTERVAL ticks each; requests add up until the sim
+// thread gets to them.
+void requestSimRewind(SimThread *sim, int32_t steps)
+{
+	atomic_fetch_add(&sim->rewindSteps, steps);
+}
+
+void requestSimSaveState(SimThread *sim)
+{
+	atomic_store(&sim->saveStateRequested, true);
+}
+
+void requestSimLoadState(SimThread *sim)
+{
+	atomic_store(&sim->loadStateRequested, true);
+}
+
+// Newest snapshot the sim thread has published. Stays valid and unchanged
+// until the next call; fresh says whether it is a new one.
+const FrameSnapshot *acquireFrameSnapshot(SimThread *sim, bool *fresh)
+{
+	*fresh = acquireTripleBuffer(&sim->exchange);
+	return &sim->snapshots[sim->exchange.front];
+}
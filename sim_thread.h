@@ -0,0 +1,99 @@
+#ifndef SIM_THREAD_H
+#define SIM_THREAD_H
+
+#include "sim.h"
+#include "game_code.h"
+#include "platform.h"
+#include "render_commands.h"
+#include "replay.h"
+#include "snapshot.h"
+#include "triple_buffer.h"
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+// Runs the game's ticks on its own thread at a fixed SIM_HZ, independent of
+// the display rate. After each batch of ticks the sim thread records a sorted
+// command buffer into a snapshot and publishes it through a triple buffer;
+// the render thread only ever reads the newest published snapshot, so
+// neither thread waits on the other.
+
+// A stall longer than this (window drag, debugger) is dropped rather than
+// caught up on.
+#define SIM_MAX_CATCH_UP 0.25
+
+// ticks between two pushes to the rewind history
+#define SIM_HISTORY_INTERVAL 12
+
+// per-tick phase timings a snapshot carries, including those of snapshots
+// the render thread skipped; only a render stall of over a second at
+// SIM_HZ loses any
+#define SNAPSHOT_TICK_TIMINGS 128
+
+typedef struct FrameSnapshot
+{
+	RenderCommandBuffer commands;
+	int64_t tick;
+	// platformGetSeconds() when this snapshot was published
+	double publishTime;
+
+	// sim phase timings (PROFILE_SIM_TICK up to PROFILE_SIM_RECORD) for the
+	// ticks since the last snapshot the render thread took, and how long
+	// recording each snapshot since then took
+	float tickTimings[SNAPSHOT_TICK_TIMINGS][PROFILE_SIM_RECORD];
+	int32_t tickTimingCount;
+	float recordTimings[SNAPSHOT_TICK_TIMINGS];
+	int32_t recordTimingCount;
+} FrameSnapshot;
+
+typedef struct SimThread
+{
+	GameMemory *memory;
+	State *state;
+	FrameSnapshot snapshots[3];
+	TripleBuffer exchange;
+
+	// written by the render thread, read by the sim thread
+	_Atomic uint32_t heldButtons;
+	// edge-triggered buttons latched until the next tick consumes them
+	_Atomic uint32_t pressedButtons;
+	atomic_bool showColliders;
+	atomic_bool quit;
+
+	// every tick's input goes here when set; only touched by the sim thread
+	// while it runs
+	ReplayWriter *recorder;
+	// gameplay code the ticks run through, reloaded between batches when it
+	// changes; NULL runs the linked-in GameUpdateAndRender
+	GameCode *code;
+	// rewind history, pushed every SIM_HISTORY_INTERVAL ticks; NULL disables
+	// rewinding
+	SnapshotRing *history;
+	// save state file for requestSimSaveState / requestSimLoadState
+	const char *statePath;
+
+	// requests from the render thread, carried out between two ticks
+	_Atomic int32_t rewindSteps;
+	atomic_bool saveStateRequested;
+	atomic_bool loadStateRequested;
+	// the sim thread's own phase timings; memory->profiler points here
+	Profiler profiler;
+
+	PlatformThread thread;
+	bool running;
+} SimThread;
+
+//functions==================
+//
+bool initSimThread(SimThread *sim, GameMemory *memory, State *state, bool showColliders);
+bool startSimThread(SimThread *sim);
+void stopSimThread(SimThread *sim);
+void submitSimInput(SimThread *sim, const InputFrame *held, const InputFrame *pressed);
+void requestSimRewind(SimThread *sim, int32_t steps);
+void requestSimSaveState(SimThread *sim);
+void requestSimLoadState(SimThread *sim);
+const FrameSnapshot *acquireFrameSnapshot(SimThread *sim, bool *fresh);
+//
+//===========================
+
+#endif
@@ -0,0 +1,179 @@
+#include "snapshot.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static SnapshotHeader snapshotHeader(const GameMemory *memory, int64_t tick)
+{
+	const State *state = (const State *)memory->PermanantStorage;
+	SnapshotHeader header = {0};
+	header.magic = SNAPSHOT_MAGIC;
+	header.version = SNAPSHOT_VERSION;
+	header.tick = tick;
+	header.permanentSize = memory->PermanantStorageSize;
+	header.usedBytes = state->permanentArena.used;
+	return header;
+}
+
+// Bytes saveSnapshot needs for the state as it is now.
+size_t snapshotSize(const GameMemory *memory)
+{
+	const State *state = (const State *)memory->PermanantStorage;
+	return sizeof(SnapshotHeader) + state->permanentArena.used;
+}
+
+bool saveSnapshot(const GameMemory *memory, int64_t tick, void *buffer, size_t bufferSize)
+{
+	if (!memory->IsInitialised || bufferSize < snapshotSize(memory))
+	{
+		return false;
+	}
+	SnapshotHeader header = snapshotHeader(memory, tick);
+	memcpy(buffer, &header, sizeof(header));
+	memcpy((uint8_t *)buffer + sizeof(header), memory->PermanantStorage, (size_t)header.usedBytes);
+	return true;
+}
+
+// The host sizes buffers from the running state (the rewind ring's slots,
+// the render command buffers), so once there is one a snapshot has to have
+// the same layout: same config, same bytes.
+static bool matchesLiveState(const GameMemory *memory, const SnapshotHeader *header, const void *payload)
+{
+	if (!memory->IsInitialised)
+	{
+		return true;
+	}
+	const State *live = (const State *)memory->PermanantStorage;
+	State saved;
+	memcpy(&saved, payload, sizeof(saved));
+	return header->usedBytes == live->permanentArena.used
+		&& saved.waveCount == live->waveCount
+		&& saved.enemyCount == live->enemyCount
+		&& saved.playerBullets.capacity == live->playerBullets.capacity;
+}
+
+// Only between ticks: nothing may be reading or writing the state meanwhile.
+bool restoreSnapshot(GameMemory *memory, const void *buffer, size_t bufferSize, int64_t *tick)
+{
+	SnapshotHeader header;
+	if (bufferSize < sizeof(header))
+	{
+		return false;
+	}
+	memcpy(&header, buffer, sizeof(header));
+	if (header.magic != SNAPSHOT_MAGIC || header.version != SNAPSHOT_VERSION
+		|| header.permanentSize != memory->PermanantStorageSize
+		|| header.usedBytes < sizeof(State) || header.usedBytes > header.permanentSize
+		|| bufferSize - sizeof(header) < header.usedBytes
+		|| !matchesLiveState(memory, &header, (const uint8_t *)buffer + sizeof(header)))
+	{
+		return false;
+	}
+
+	if (!memory->IsInitialised && !initTransientState(memory))
+	{
+		return false;
+	}
+	memcpy(memory->PermanantStorage, (const uint8_t *)buffer + sizeof(header), (size_t)header.usedBytes);
+	memory->IsInitialised = true;
+	if (tick)
+	{
+		*tick = header.tick;
+	}
+	return true;
+}
+
+// Slots are sized for the state as it is now; the game never grows
+// permanent storage after initState.
+bool initSnapshotRing(SnapshotRing *ring, MemoryArena *arena, const GameMemory *memory, int32_t capacity)
+{
+	ring->slotSize = snapshotSize(memory);
+	ring->slots = (uint8_t *)pushSize(arena, ring->slotSize * (size_t)capacity, DEFAULT_ARENA_ALIGNMENT);
+	ring->capacity = ring->slots ? capacity : 0;
+	ring->next = 0;
+	ring->count = 0;
+	return ring->slots != NULL;
+}
+
+void pushSnapshot(SnapshotRing *ring, const GameMemory *memory, int64_t tick)
+{
+	if (ring->capacity == 0)
+	{
+		return;
+	}
+	if (saveSnapshot(memory, tick, ring->slots + (size_t)ring->next * ring->slotSize, ring->slotSize))
+	{
+		ring->next = (ring->next + 1) % ring->capacity;
+		if (ring->count < ring->capacity)
+		{
+			ring->count++;
+		}
+	}
+}
+
+// Restores the snapshot steps pushes back, the newest being 1, and forgets
+// it and everything after it so the next rewind goes further back. Clamps
+// to the oldest, which is kept.
+bool rewindSnapshot(SnapshotRing *ring, GameMemory *memory, int32_t steps, int64_t *tick)
+{
+	if (ring->count == 0 || steps <= 0)
+	{
+		return false;
+	}
+	if (steps > ring->count)
+	{
+		steps = ring->count;
+	}
+	int32_t slot = (ring->next - steps + ring->capacity) % ring->capacity;
+	if (!restoreSnapshot(memory, ring->slots + (size_t)slot * ring->slotSize, ring->slotSize, tick))
+	{
+		return false;
+	}
+	if (steps == ring->count)
+	{
+		ring->next = (slot + 1) % ring->capacity;
+		ring->count = 1;
+	}
+	else
+	{
+		ring->next = slot;
+		ring->count -= steps;
+	}
+	return true;
+}
+
+bool writeSnapshotFile(const GameMemory *memory, int64_t tick, const char *path)
+{
+	if (!memory->IsInitialised)
+	{
+		return false;
+	}
+	FILE *file = fopen(path, "wb");
+	if (!file)
+	{
+		return false;
+	}
+	SnapshotHeader header = snapshotHeader(memory, tick);
+	bool ok = fwrite(&header, sizeof(header), 1, file) == 1
+		&& fwrite(memory->PermanantStorage, 1, (size_t)header.usedBytes, file) == header.usedBytes;
+	ok = (fclose(file) == 0) && ok;
+	return ok;
+}
+
+bool readSnapshotFile(GameMemory *memory, const char *path, int64_t *tick)
+{
+	FILE *file = fopen(path, "rb");
+	if (!file)
+	{
+		return false;
+	}
+	bool ok = fseek(file, 0, SEEK_END) == 0;
+	long size = ok ? ftell(file) : -1;
+	ok = ok && size > 0 && fseek(file, 0, SEEK_SET) == 0;
+	uint8_t *buffer = ok ? (uint8_t *)malloc((size_t)size) : NULL;
+	ok = buffer && fread(buffer, 1, (size_t)size, file) == (size_t)size;
+	fclose(file);
+	ok = ok && restoreSnapshot(memory, buffer, (size_t)size, tick);
+	free(buffer);
+	return ok;
+}
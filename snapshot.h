@@ -0,0 +1,61 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include "sim.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Save states. All game state is the used part of the permanent arena, and
+// it holds no addresses (see State), so a snapshot is one block copy of it
+// behind a small header and restoring is the copy back; a snapshot written
+// by one process loads in another as is, and two runs at the same tick
+// write byte-for-byte identical snapshots. Transient storage and the host's
+// services in GameMemory are not game state and are left alone.
+//
+// A snapshot only loads into memory set up with the same block sizes. Once
+// the memory is initialised it also has to match the running config (wave,
+// enemy and bullet counts), since the host sized its buffers from that;
+// into fresh memory the config comes from the snapshot itself.
+//
+// File layout is the header followed by usedBytes of permanent storage, in
+// host byte order; save states are for the machine that wrote them.
+
+#define SNAPSHOT_MAGIC 0x50534953u // "SISP"
+#define SNAPSHOT_VERSION 4
+
+typedef struct SnapshotHeader
+{
+	uint32_t magic;
+	uint32_t version;
+	int64_t tick;
+	uint64_t permanentSize;
+	uint64_t usedBytes;
+} SnapshotHeader;
+
+// Fixed-size slots the sim thread fills every few ticks, oldest overwritten
+// first, for rewinding.
+typedef struct SnapshotRing
+{
+	uint8_t *slots;
+	size_t slotSize;
+	int32_t capacity;
+	// slot the next push goes to
+	int32_t next;
+	int32_t count;
+} SnapshotRing;
+
+//functions==================
+//
+size_t snapshotSize(const GameMemory *memory);
+bool saveSnapshot(const GameMemory *memory, int64_t tick, void *buffer, size_t bufferSize);
+bool restoreSnapshot(GameMemory *memory, const void *buffer, size_t bufferSize, int64_t *tick);
+bool initSnapshotRing(SnapshotRing *ring, MemoryArena *arena, const GameMemory *memory, int32_t capacity);
+void pushSnapshot(SnapshotRing *ring, const GameMemory *memory, int64_t tick);
+bool rewindSnapshot(SnapshotRing *ring, GameMemory *memory, int32_t steps, int64_t *tick);
+bool writeSnapshotFile(const GameMemory *memory, int64_t tick, const char *path);
+bool readSnapshotFile(GameMemory *memory, const char *path, int64_t *tick);
+//
+//===========================
+
+#endif
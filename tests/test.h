@@ -0,0 +1,33 @@
+#ifndef TEST_H
+#define TEST_H
+
+#include <stdio.h>
+
+// Just enough for the unit tests: CHECK reports a failed condition and
+// carries on so one run shows every failure, and main returns
+// testResult() so ctest sees them.
+
+static int testFailures = 0;
+
+#define CHECK(Condition) \
+	do \
+	{ \
+		if (!(Condition)) \
+		{ \
+			fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #Condition); \
+			testFailures++; \
+		} \
+	} while (0)
+
+static int testResult(const char *name)
+{
+	if (testFailures)
+	{
+		fprintf(stderr, "%s: %d checks failed\n", name, testFailures);
+		return 1;
+	}
+	printf("%s: ok\n", name);
+	return 0;
+}
+
+#endif
@@ -0,0 +1,131 @@
+#include "test.h"
+#include "bullets.h"
+#include "rng.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define TEST_CAPACITY 1003
+
+static uint8_t memory[Megabytes(1)];
+
+static void fillPool(BulletPool *pool, Rng *rng, int32_t count)
+{
+	clearBulletPool(pool);
+	for (int32_t i = 0; i < count; i++)
+	{
+		Vector2 position = { randomUnit(rng) * 640.0f, randomUnit(rng) * 400.0f - 40.0f };
+		Vector2 velocity = { randomUnit(rng) * 100.0f - 50.0f, -randomUnit(rng) * BULLET_SPEED };
+		CHECK(spawnBullet(pool, position, velocity) == i);
+	}
+}
+
+// The vector kernels against the plain loop they replace, over counts that
+// end on and off a lane boundary.
+static void testIntegrateMatchesScalar(BulletPool *pool, Rng *rng)
+{
+	static const int32_t counts[] = { 0, 1, 3, 4, 5, 8, 9, 17, 1000, TEST_CAPACITY };
+	static float x[TEST_CAPACITY];
+	static float y[TEST_CAPACITY];
+	float dt = 1.0f / 120.0f;
+	for (size_t c = 0; c < sizeof(counts) / sizeof(counts[0]); c++)
+	{
+		int32_t count = counts[c];
+		fillPool(pool, rng, count);
+		BulletArrays bullets = bulletArrays(pool);
+		for (int32_t i = 0; i < count; i++)
+		{
+			x[i] = bullets.x[i] + bullets.vx[i] * dt;
+			y[i] = bullets.y[i] + bullets.vy[i] * dt;
+		}
+		integrateBullets(pool, dt);
+		CHECK(memcmp(bullets.x, x, sizeof(float) * count) == 0);
+		CHECK(memcmp(bullets.y, y, sizeof(float) * count) == 0);
+	}
+
+	// lane-aligned ranges, as the job system splits them, cover the same ground
+	fillPool(pool, rng, 1000);
+	BulletArrays bullets = bulletArrays(pool);
+	for (int32_t i = 0; i < 1000; i++)
+	{
+		x[i] = bullets.x[i] + bullets.vx[i] * dt;
+		y[i] = bullets.y[i] + bullets.vy[i] * dt;
+	}
+	integrateBulletRange(pool, 0, 64, dt);
+	integrateBulletRange(pool, 64, 512, dt);
+	integrateBulletRange(pool, 512, 1000, dt);
+	CHECK(memcmp(bullets.x, x, sizeof(float) * 1000) == 0);
+	CHECK(memcmp(bullets.y, y, sizeof(float) * 1000) == 0);
+}
+
+static int compareFloats(const void *a, const void *b)
+{
+	float fa = *(const float *)a;
+	float fb = *(const float *)b;
+	return (fa > fb) - (fa < fb);
+}
+
+// Culling reorders the pool, so compare what survives as a sorted set.
+static void testCullMatchesScalar(BulletPool *pool, Rng *rng)
+{
+	static const int32_t counts[] = { 1, 7, 8, 9, 63, 500, TEST_CAPACITY };
+	static float expected[TEST_CAPACITY];
+	static float survivors[TEST_CAPACITY];
+	float minY = 0.0f;
+	for (size_t c = 0; c < sizeof(counts) / sizeof(counts[0]); c++)
+	{
+		int32_t count = counts[c];
+		fillPool(pool, rng, count);
+		BulletArrays bullets = bulletArrays(pool);
+		int32_t kept = 0;
+		for (int32_t i = 0; i < count; i++)
+		{
+			if (!(bullets.y[i] < minY))
+			{
+				expected[kept++] = bullets.y[i];
+			}
+		}
+
+		CHECK(cullBullets(pool, minY) == count - kept);
+		CHECK(pool->count == kept);
+		memcpy(survivors, bullets.y, sizeof(float) * pool->count);
+		qsort(survivors, pool->count, sizeof(float), compareFloats);
+		qsort(expected, kept, sizeof(float), compareFloats);
+		CHECK(memcmp(survivors, expected, sizeof(float) * kept) == 0);
+	}
+}
+
+static void testSpawnAndDespawn(BulletPool *pool)
+{
+	clearBulletPool(pool);
+	for (int32_t i = 0; i < TEST_CAPACITY; i++)
+	{
+		spawnBullet(pool, (Vector2){ (float)i, 0.0f }, (Vector2){ 0.0f, -BULLET_SPEED });
+	}
+	CHECK(spawnBullet(pool, (Vector2){ 0.0f, 0.0f }, (Vector2){ 0.0f, 0.0f }) == -1);
+
+	// the last bullet moves into the freed slot
+	despawnBullet(pool, 10);
+	CHECK(pool->count == TEST_CAPACITY - 1);
+	CHECK(bulletArrays(pool).x[10] == (float)(TEST_CAPACITY - 1));
+}
+
+int main(void)
+{
+	MemoryArena arena;
+	initArena(&arena, "test", memory, sizeof(memory));
+	// in the same block as its arrays, like the one in State
+	BulletPool *pool = PushStruct(&arena, BulletPool);
+	bool ready = pool && initBulletPool(pool, &arena, TEST_CAPACITY);
+	CHECK(ready);
+	if (!ready)
+	{
+		return testResult("test_bullets");
+	}
+	Rng rng;
+	seedRng(&rng, 1, 2);
+
+	testIntegrateMatchesScalar(pool, &rng);
+	testCullMatchesScalar(pool, &rng);
+	testSpawnAndDespawn(pool);
+	return testResult("test_bullets");
+}
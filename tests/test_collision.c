@@ -0,0 +1,160 @@
+#include "test.h"
+#include "collision.h"
+#include "rng.h"
+#include <math.h>
+
+static uint8_t memory[Megabytes(4)];
+
+static Rectangle randomBox(Rng *rng, float maxSize)
+{
+	Rectangle box;
+	box.x = randomUnit(rng) * 700.0f - 30.0f;
+	box.y = randomUnit(rng) * 380.0f - 30.0f;
+	box.width = 1.0f + randomUnit(rng) * maxSize;
+	box.height = 1.0f + randomUnit(rng) * maxSize;
+	return box;
+}
+
+static bool maskBit(const uint32_t *mask, int32_t i)
+{
+	return (mask[i >> 5] >> (i & 31)) & 1u;
+}
+
+// The vector mask against checkCollision, box by box, including offsets
+// and counts that leave a scalar tail.
+static void testOverlapMaskMatchesScalar(MemoryArena *arena, Rng *rng)
+{
+	ArenaMark mark = arenaMark(arena);
+	Rectangle boxes[301];
+	ColliderSoA colliders;
+	CHECK(initColliderSoA(&colliders, arena, 301));
+	for (int32_t i = 0; i < 301; i++)
+	{
+		boxes[i] = randomBox(rng, 80.0f);
+		setCollider(&colliders, i, boxes[i]);
+	}
+	// touching edges do not overlap
+	boxes[0] = (Rectangle){ 100.0f, 100.0f, 10.0f, 10.0f };
+	setCollider(&colliders, 0, boxes[0]);
+
+	static const int32_t firsts[] = { 0, 1, 5, 37 };
+	static const int32_t counts[] = { 1, 3, 4, 9, 32, 33, 200, 264 };
+	uint32_t mask[16];
+	for (int32_t trial = 0; trial < 200; trial++)
+	{
+		Rectangle box = randomBox(rng, 120.0f);
+		if (trial == 0)
+		{
+			box = (Rectangle){ 110.0f, 100.0f, 10.0f, 10.0f };
+		}
+		for (size_t f = 0; f < sizeof(firsts) / sizeof(firsts[0]); f++)
+		{
+			for (size_t c = 0; c < sizeof(counts) / sizeof(counts[0]); c++)
+			{
+				int32_t first = firsts[f];
+				int32_t count = counts[c];
+				aabbOverlapMask(box, &colliders, first, count, mask);
+				for (int32_t i = 0; i < count; i++)
+				{
+					CHECK(maskBit(mask, i) == checkCollision(box, boxes[first + i]));
+				}
+			}
+		}
+	}
+	arenaRewind(mark);
+}
+
+static void testSweptAabb(void)
+{
+	Rectangle target = { 100.0f, 0.0f, 40.0f, 20.0f };
+	Rectangle bullet = { 118.0f, 100.0f, 5.0f, 10.0f };
+	float toi = -1.0f;
+
+	// a fast bullet that would jump clean over the target in one tick
+	CHECK(!checkCollision(bullet, target));
+	CHECK(!checkCollision((Rectangle){ 118.0f, -200.0f, 5.0f, 10.0f }, target));
+	CHECK(sweptAabb(bullet, (Vector2){ 0.0f, -300.0f }, target, &toi));
+	CHECK(fabsf(toi - 80.0f / 300.0f) < 1e-6f);
+
+	// stops short
+	CHECK(!sweptAabb(bullet, (Vector2){ 0.0f, -50.0f }, target, &toi));
+	// passes beside it
+	CHECK(!sweptAabb((Rectangle){ 200.0f, 100.0f, 5.0f, 10.0f }, (Vector2){ 0.0f, -300.0f }, target, &toi));
+	// diagonal, entering through the side
+	CHECK(sweptAabb((Rectangle){ 60.0f, 5.0f, 5.0f, 5.0f }, (Vector2){ 80.0f, 0.0f }, target, &toi));
+	CHECK(fabsf(toi - 35.0f / 80.0f) < 1e-6f);
+
+	// already overlapping hits at the start; standing still away from it never does
+	CHECK(sweptAabb((Rectangle){ 110.0f, 5.0f, 5.0f, 5.0f }, (Vector2){ 0.0f, -300.0f }, target, &toi));
+	CHECK(toi == 0.0f);
+	CHECK(sweptAabb((Rectangle){ 110.0f, 5.0f, 5.0f, 5.0f }, (Vector2){ 0.0f, 0.0f }, target, &toi));
+	CHECK(!sweptAabb(bullet, (Vector2){ 0.0f, 0.0f }, target, &toi));
+}
+
+// Brute force over every box with sweptAabb: earliest hit, lowest index on
+// a tie. The grid query has to agree exactly.
+static SweepHit bruteForceHit(const Rectangle *boxes, const bool *alive, int32_t count, Rectangle box, Vector2 delta)
+{
+	SweepHit best = { -1, 0.0f };
+	for (int32_t i = 0; i < count; i++)
+	{
+		float toi;
+		if (alive[i] && sweptAabb(box, delta, boxes[i], &toi) && (best.item < 0 || toi < best.toi))
+		{
+			best.item = i;
+			best.toi = toi;
+		}
+	}
+	return best;
+}
+
+static void testGridMatchesBruteForce(MemoryArena *arena, Rng *rng)
+{
+	enum { BOX_COUNT = 600 };
+	static Rectangle boxes[BOX_COUNT];
+	static bool alive[BOX_COUNT];
+	for (int32_t i = 0; i < BOX_COUNT; i++)
+	{
+		boxes[i] = randomBox(rng, 40.0f);
+		alive[i] = (i % 7) != 0;
+	}
+	// a stack of identical boxes so ties happen
+	for (int32_t i = 1; i < 4; i++)
+	{
+		boxes[i] = boxes[0];
+	}
+
+	ArenaMark mark = arenaMark(arena);
+	CollisionGrid grid;
+	initCollisionGrid(&grid, 640.0f, 320.0f, COLLISION_CELL_SIZE);
+	CHECK(buildCollisionGrid(&grid, arena, boxes, BOX_COUNT));
+
+	for (int32_t trial = 0; trial < 5000; trial++)
+	{
+		Rectangle box = { randomUnit(rng) * 640.0f, randomUnit(rng) * 360.0f, 5.0f, 10.0f };
+		Vector2 delta = { randomUnit(rng) * 60.0f - 30.0f, -randomUnit(rng) * 400.0f };
+		if (trial == 0)
+		{
+			box = (Rectangle){ boxes[0].x, boxes[0].y + 200.0f, 5.0f, 10.0f };
+			delta = (Vector2){ 0.0f, -400.0f };
+		}
+		SweepHit expected = bruteForceHit(boxes, alive, BOX_COUNT, box, delta);
+		SweepHit hit = gridFirstSweptHit(&grid, alive, box, delta);
+		CHECK(hit.item == expected.item);
+		CHECK(hit.item < 0 || hit.toi == expected.toi);
+	}
+	arenaRewind(mark);
+}
+
+int main(void)
+{
+	MemoryArena arena;
+	initArena(&arena, "test", memory, sizeof(memory));
+	Rng rng;
+	seedRng(&rng, 3, 4);
+
+	testOverlapMaskMatchesScalar(&arena, &rng);
+	testSweptAabb();
+	testGridMatchesBruteForce(&arena, &rng);
+	return testResult("test_collision");
+}
@@ -0,0 +1,178 @@
+#include "test.h"
+#include "replay.h"
+#include <stdlib.h>
+
+#define TEST_TICKS 50000
+
+// Input for tick i: short runs, single ticks, and runs long enough to need
+// two- and three-byte varints.
+static uint8_t scriptedButtons(int64_t tick)
+{
+	if (tick < 300)
+	{
+		return (uint8_t)((tick / 7) % 3);
+	}
+	if (tick < 20000)
+	{
+		return INPUT_LEFT | INPUT_SHOOT;
+	}
+	if (tick < 20003)
+	{
+		return (uint8_t)(tick & INPUT_UP);
+	}
+	return INPUT_RIGHT;
+}
+
+static long fileSize(const char *path)
+{
+	FILE *file = fopen(path, "rb");
+	if (!file)
+	{
+		return -1;
+	}
+	fseek(file, 0, SEEK_END);
+	long size = ftell(file);
+	fclose(file);
+	return size;
+}
+
+static bool truncateFile(const char *path, long size)
+{
+	FILE *file = fopen(path, "rb");
+	uint8_t *data = (uint8_t *)malloc((size_t)size);
+	bool ok = file && data && fread(data, 1, (size_t)size, file) == (size_t)size;
+	if (file)
+	{
+		fclose(file);
+	}
+	file = ok ? fopen(path, "wb") : NULL;
+	ok = file && fwrite(data, 1, (size_t)size, file) == (size_t)size;
+	if (file)
+	{
+		fclose(file);
+	}
+	free(data);
+	return ok;
+}
+
+static void testRoundTrip(const char *path)
+{
+	SimConfig config = defaultSimConfig();
+	config.seed = 1234;
+	config.waveCount = 3;
+	config.enemyCount = 17;
+	config.bulletCapacity = 999;
+
+	ReplayWriter writer;
+	CHECK(openReplayWriter(&writer, path, &config, 240));
+	for (int64_t tick = 0; tick < TEST_TICKS; tick++)
+	{
+		InputFrame input = { scriptedButtons(tick) };
+		recordReplayInput(&writer, &input);
+	}
+	CHECK(closeReplayWriter(&writer, 0x0123456789abcdefull));
+	// run-length coding keeps this tiny
+	CHECK(fileSize(path) > REPLAY_HEADER_SIZE && fileSize(path) < 200);
+
+	ReplayReader reader;
+	CHECK(loadReplay(&reader, path));
+	CHECK(reader.header.version == REPLAY_VERSION);
+	CHECK(reader.header.hz == 240);
+	CHECK(reader.header.tickCount == TEST_TICKS);
+	CHECK(reader.header.finalHash == 0x0123456789abcdefull);
+	SimConfig loaded = replayConfig(&reader.header);
+	CHECK(loaded.seed == config.seed);
+	CHECK(loaded.waveCount == config.waveCount);
+	CHECK(loaded.enemyCount == config.enemyCount);
+	CHECK(loaded.bulletCapacity == config.bulletCapacity);
+
+	int64_t mismatches = 0;
+	for (int64_t tick = 0; tick < TEST_TICKS; tick++)
+	{
+		InputFrame input = {0};
+		if (!nextReplayInput(&reader, &input) || input.buttons != scriptedButtons(tick))
+		{
+			mismatches++;
+		}
+	}
+	CHECK(mismatches == 0);
+	InputFrame past = {0};
+	CHECK(!nextReplayInput(&reader, &past));
+	unloadReplay(&reader);
+}
+
+// Overwrites a little-endian u32 header field in place.
+static bool patchU32(const char *path, long offset, uint32_t value)
+{
+	FILE *file = fopen(path, "r+b");
+	uint8_t bytes[4] = { (uint8_t)value, (uint8_t)(value >> 8), (uint8_t)(value >> 16), (uint8_t)(value >> 24) };
+	bool ok = file && fseek(file, offset, SEEK_SET) == 0 && fwrite(bytes, 1, 4, file) == 4;
+	if (file)
+	{
+		fclose(file);
+	}
+	return ok;
+}
+
+// Losing the last run must show up as running out early, and a file cut
+// inside the header, with the wrong version or with a config no host could
+// run must not load at all.
+static void testDamagedFiles(const char *path)
+{
+	ReplayReader reader;
+	static const struct { long offset; uint32_t value; } badConfigs[] = {
+		{ 12, (uint32_t)-3 },   // bulletCapacity
+		{ 12, 0 },
+		{ 16, 50000000 },       // waveCount
+		{ 16, 0 },
+		{ 20, (uint32_t)-1 },   // enemyCount
+		{ 20, SIM_MAX_ENEMIES / 3 },
+	};
+	for (size_t i = 0; i < sizeof(badConfigs) / sizeof(badConfigs[0]); i++)
+	{
+		uint32_t original[3];
+		CHECK(loadReplay(&reader, path));
+		original[0] = (uint32_t)reader.header.bulletCapacity;
+		original[1] = (uint32_t)reader.header.waveCount;
+		original[2] = (uint32_t)reader.header.enemyCount;
+		unloadReplay(&reader);
+
+		CHECK(patchU32(path, badConfigs[i].offset, badConfigs[i].value));
+		CHECK(!loadReplay(&reader, path));
+		CHECK(patchU32(path, badConfigs[i].offset, original[(badConfigs[i].offset - 12) / 4]));
+	}
+
+	long size = fileSize(path);
+	CHECK(truncateFile(path, size - 2));
+	CHECK(loadReplay(&reader, path));
+	int64_t ticks = 0;
+	InputFrame input;
+	while (nextReplayInput(&reader, &input))
+	{
+		ticks++;
+	}
+	CHECK(ticks < TEST_TICKS);
+	unloadReplay(&reader);
+
+	CHECK(truncateFile(path, REPLAY_HEADER_SIZE - 1));
+	CHECK(!loadReplay(&reader, path));
+
+	FILE *file = fopen(path, "wb");
+	uint8_t header[REPLAY_HEADER_SIZE] = { 'S', 'I', 'R', 'P', REPLAY_VERSION - 1, 0, 120, 0 };
+	CHECK(file && fwrite(header, 1, sizeof(header), file) == sizeof(header));
+	if (file)
+	{
+		fclose(file);
+	}
+	CHECK(!loadReplay(&reader, path));
+	CHECK(!loadReplay(&reader, "no-such-file.replay"));
+}
+
+int main(int argc, char **argv)
+{
+	const char *path = argc > 1 ? argv[1] : "test_replay.replay";
+	testRoundTrip(path);
+	testDamagedFiles(path);
+	remove(path);
+	return testResult("test_replay");
+}
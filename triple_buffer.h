@@ -0,0 +1,52 @@
+#ifndef TRIPLE_BUFFER_H
+#define TRIPLE_BUFFER_H
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+// Lock-free single-producer / single-consumer exchange of three slots. The
+// writer always owns back and the reader always owns front; publishing and
+// acquiring swap with the shared middle slot, so neither side ever waits on
+// the other and the reader always gets the newest completed slot.
+typedef struct TripleBuffer
+{
+	_Atomic uint32_t middle;
+	uint32_t back;
+	uint32_t front;
+} TripleBuffer;
+
+#define TRIPLE_BUFFER_FRESH 0x4u
+#define TRIPLE_BUFFER_INDEX 0x3u
+
+static inline void initTripleBuffer(TripleBuffer *buffer)
+{
+	buffer->front = 0;
+	atomic_store(&buffer->middle, 1u);
+	buffer->back = 2;
+}
+
+// Writer: hands the filled back slot over; back is the next one to fill.
+// Returns true when that slot was published before and never acquired, so
+// anything the reader has to see from it can be carried forward.
+static inline bool publishTripleBuffer(TripleBuffer *buffer)
+{
+	uint32_t previous = atomic_exchange_explicit(&buffer->middle, buffer->back | TRIPLE_BUFFER_FRESH, memory_order_acq_rel);
+	buffer->back = previous & TRIPLE_BUFFER_INDEX;
+	return (previous & TRIPLE_BUFFER_FRESH) != 0;
+}
+
+// Reader: takes the newest published slot if there is one. front is the slot
+// to read either way.
+static inline bool acquireTripleBuffer(TripleBuffer *buffer)
+{
+	if (!(atomic_load_explicit(&buffer->middle, memory_order_relaxed) & TRIPLE_BUFFER_FRESH))
+	{
+		return false;
+	}
+	uint32_t previous = atomic_exchange_explicit(&buffer->middle, buffer->front, memory_order_acq_rel);
+	buffer->front = previous & TRIPLE_BUFFER_INDEX;
+	return true;
+}
+
+#endif